@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// Counts heap allocations, so benchmarks can report allocations/op and
+// check that hot paths stay allocation-free. A program switches the count
+// on by defining MONOPOLY_COUNT_ALLOCATIONS before including this header in
+// exactly one of its source files: that file then replaces the global
+// operator new. Without it every count reads zero.
+//
+// Each thread counts its own allocations too, so a check on one thread is
+// not thrown off by others allocating at the same time.
+namespace allocations {
+
+namespace detail {
+
+inline std::atomic<uint64_t> total{0};
+inline thread_local uint64_t thisThread = 0;
+
+inline void count() {
+    total.fetch_add(1, std::memory_order_relaxed);
+    thisThread++;
+}
+
+} // namespace detail
+
+// Allocations by every thread since the program started
+inline uint64_t processCount() { return detail::total.load(std::memory_order_relaxed); }
+
+// Allocations by the calling thread since it started
+inline uint64_t threadCount() { return detail::thisThread; }
+
+// Allocations on the calling thread while it is in scope
+class Scope {
+private:
+    uint64_t start;
+
+public:
+    Scope() : start(threadCount()) {}
+
+    uint64_t count() const { return threadCount() - start; }
+};
+
+} // namespace allocations
+
+#ifdef MONOPOLY_COUNT_ALLOCATIONS
+namespace allocations {
+namespace detail {
+
+inline void* allocate(size_t size) {
+    count();
+    return malloc(size ? size : 1);
+}
+
+// aligned_alloc wants a multiple of the alignment
+inline void* allocate(size_t size, std::align_val_t alignment) {
+    count();
+    size_t align = size_t(alignment);
+    return aligned_alloc(align, (size + align - 1) / align * align);
+}
+
+} // namespace detail
+} // namespace allocations
+
+// Every replaceable form is counted: plain, array, over-aligned and nothrow.
+// Kept out of line: GCC otherwise inlines delete next to new and warns
+// about free() on memory from operator new.
+__attribute__((noinline)) void* operator new(size_t size) {
+    if (void* p = allocations::detail::allocate(size)) return p;
+    throw std::bad_alloc();
+}
+__attribute__((noinline)) void* operator new[](size_t size) {
+    if (void* p = allocations::detail::allocate(size)) return p;
+    throw std::bad_alloc();
+}
+__attribute__((noinline)) void* operator new(size_t size, std::align_val_t alignment) {
+    if (void* p = allocations::detail::allocate(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+__attribute__((noinline)) void* operator new[](size_t size, std::align_val_t alignment) {
+    if (void* p = allocations::detail::allocate(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+__attribute__((noinline)) void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return allocations::detail::allocate(size);
+}
+__attribute__((noinline)) void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return allocations::detail::allocate(size);
+}
+__attribute__((noinline)) void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocations::detail::allocate(size, alignment);
+}
+__attribute__((noinline)) void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocations::detail::allocate(size, alignment);
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept { free(p); }
+__attribute__((noinline)) void operator delete[](void* p) noexcept { free(p); }
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { free(p); }
+__attribute__((noinline)) void operator delete[](void* p, size_t) noexcept { free(p); }
+__attribute__((noinline)) void operator delete(void* p, std::align_val_t) noexcept { free(p); }
+__attribute__((noinline)) void operator delete[](void* p, std::align_val_t) noexcept { free(p); }
+__attribute__((noinline)) void operator delete(void* p, size_t, std::align_val_t) noexcept { free(p); }
+__attribute__((noinline)) void operator delete[](void* p, size_t, std::align_val_t) noexcept { free(p); }
+__attribute__((noinline)) void operator delete(void* p, const std::nothrow_t&) noexcept { free(p); }
+__attribute__((noinline)) void operator delete[](void* p, const std::nothrow_t&) noexcept { free(p); }
+__attribute__((noinline)) void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { free(p); }
+__attribute__((noinline)) void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { free(p); }
+#endif
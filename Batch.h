@@ -0,0 +1,583 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MONOPOLY_HAVE_AVX2_KERNEL 1
+#endif
+#include "Cards.h"
+#include "MonopolyDeal.h"
+#include "Moves.h"
+#include "Policies.h"
+#include "Rng.h"
+
+namespace detail {
+
+// The kinds of card greedyMove ranks, highest first; the batch simulator
+// reads them from a table rather than branching on CardInfo
+enum GreedyKind : uint8_t {
+    GREEDY_NONE, GREEDY_DEAL_BREAKER, GREEDY_PROPERTY, GREEDY_WILD, GREEDY_SLY_DEAL, GREEDY_RENT, GREEDY_MONEY,
+    GREEDY_KINDS
+};
+
+constexpr std::array<uint8_t, NUM_CARDS> buildGreedyKinds() {
+    std::array<uint8_t, NUM_CARDS> kinds{};
+    for (int id = 0; id < NUM_CARDS; id++) {
+        const CardInfo& info = CARD_CATALOG[id];
+        if (info.type == CardType::PROPERTY) kinds[id] = info.isWild ? GREEDY_WILD : GREEDY_PROPERTY;
+        else if (info.type == CardType::MONEY) kinds[id] = GREEDY_MONEY;
+        else if (info.type == CardType::RENT) kinds[id] = GREEDY_RENT;
+        else if (info.action == ActionKind::DEAL_BREAKER) kinds[id] = GREEDY_DEAL_BREAKER;
+        else if (info.action == ActionKind::SLY_DEAL) kinds[id] = GREEDY_SLY_DEAL;
+    }
+    return kinds;
+}
+constexpr std::array<uint8_t, NUM_CARDS> GREEDY_KIND = buildGreedyKinds();
+
+}  // namespace detail
+
+// Set bookkeeping for a whole batch at once. Arrays are color-major with one
+// byte lane per game: real[c * stride + g]. For every game this finds which
+// colors are complete under `sizes` (a rules type's SET_SIZES), how many
+// there are (the win check) and the rent a rent card would charge: 2 x the
+// set size for each complete color with an entry on the table, as in
+// PropertyTableau. Only the first `lanes` games are updated; `stride` (the
+// distance between colors) and `lanes` are multiples of 32.
+namespace batchkernel {
+
+inline void updateSetsScalar(const uint8_t* sizes, const uint8_t* real, const uint8_t* wild, const uint8_t* listed,
+                             uint8_t* complete, uint8_t* count, uint8_t* rent, size_t stride, size_t lanes) {
+    std::fill(count, count + lanes, 0);
+    std::fill(rent, rent + lanes, 0);
+    for (int c = 0; c < NUM_COLORS; c++) {
+        for (size_t g = 0; g < lanes; g++) {
+            size_t lane = c * stride + g;
+            uint8_t full = real[lane] + wild[lane] >= sizes[c];
+            complete[lane] = full;
+            count[g] += full;
+            rent[g] += uint8_t(full & (listed[lane] != 0)) * uint8_t(2 * sizes[c]);
+        }
+    }
+}
+
+#ifdef MONOPOLY_HAVE_AVX2_KERNEL
+// 32 games per instruction. Counts stay below 128, so signed byte compares work.
+__attribute__((target("avx2"))) inline void updateSetsAvx2(const uint8_t* sizes, const uint8_t* real,
+                                                           const uint8_t* wild, const uint8_t* listed, uint8_t* complete,
+                                                           uint8_t* count, uint8_t* rent, size_t stride,
+                                                           size_t lanes) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi8(1);
+    for (size_t g = 0; g < lanes; g += 32) {
+        __m256i sets = zero, charge = zero;
+        for (int c = 0; c < NUM_COLORS; c++) {
+            size_t lane = c * stride + g;
+            __m256i total = _mm256_add_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(real + lane)),
+                                            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(wild + lane)));
+            __m256i full = _mm256_cmpgt_epi8(total, _mm256_set1_epi8(char(sizes[c] - 1)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(complete + lane), _mm256_and_si256(full, one));
+            sets = _mm256_sub_epi8(sets, full);
+            __m256i onTable = _mm256_cmpgt_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(listed + lane)), zero);
+            __m256i charged = _mm256_and_si256(_mm256_and_si256(full, onTable), _mm256_set1_epi8(char(2 * sizes[c])));
+            charge = _mm256_add_epi8(charge, charged);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(count + g), sets);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(rent + g), charge);
+    }
+}
+
+inline bool cpuHasAvx2() { return __builtin_cpu_supports("avx2"); }
+#else
+inline bool cpuHasAvx2() { return false; }
+#endif
+
+}  // namespace batchkernel
+
+// Plays thousands of games in lockstep with greedyMove at every seat. Each
+// step makes one decision in every running game. State is kept as structure
+// of arrays (per-color counts, money, hand sizes, pile cursors) so the set
+// checks, rent and win check for the whole batch run as one vector kernel.
+// Arrays are indexed by lane rather than by game: running games stay packed
+// into the first `active` lanes (a finished game's results are saved and the
+// last running game moves into its lane), so the kernel only covers games
+// still in play. Play-phase decisions rank the hand from a table
+// (greedyPlay) instead of calling greedyMove card by card.
+// Follows BasicMonopolyDealGame<Rules> exactly: the same seeds give the same
+// winners, turn counts and money as the engine with BasicGreedyPolicy<Rules>.
+template <class Rules>
+class BasicBatchSimulator {
+    static_assert(validRules<Rules>(), "invalid rules type");
+
+public:
+    enum class Kernel { AUTO, SCALAR, AVX2 };
+
+private:
+    static constexpr int MAX_HAND = maxHandSize<Rules>();
+    static constexpr std::array<uint8_t, NUM_COLORS> SIZES = Rules::SET_SIZES;
+
+    size_t games;
+    size_t stride;
+    size_t active = 0;
+    int players;
+    int maxTurns;
+    bool useAvx2;
+
+    // Per lane: the game it holds, and that game's state
+    std::vector<uint32_t> gameOf;
+    std::vector<Xoshiro256> rng;
+    std::vector<uint8_t> current;
+    std::vector<GamePhase> phase;
+    std::vector<uint8_t> plays;
+    std::vector<int8_t> winner;
+    std::vector<int32_t> turns;
+    std::vector<CardId> drawCards;      // NUM_CARDS per lane, top at the end
+    std::vector<uint8_t> drawCount;
+    std::vector<CardId> discardCards;
+    std::vector<uint8_t> discardCount;
+
+    // Per seat and game, at [seat * stride + g]
+    std::vector<CardId> handCards;      // MAX_HAND per seat and game
+    std::vector<uint8_t> handSize;
+    std::vector<int32_t> money;
+    std::vector<uint8_t> justSayNo;
+    std::vector<uint8_t> completeCount;
+    std::vector<uint8_t> rent;
+
+    // Per seat, color and game, at [(seat * NUM_COLORS + c) * stride + g]
+    std::vector<uint8_t> real;
+    std::vector<uint8_t> wild;
+    std::vector<uint8_t> listed;
+    std::vector<uint8_t> complete;
+
+    // Pending turn ends, filled while applying moves and settled after the
+    // set kernel has run again
+    enum Pending : uint8_t { NOTHING, END_PLAY, END_TURN };
+    std::vector<Pending> pending;
+
+    // Results by game, saved as each game finishes
+    std::vector<int8_t> finalWinner;
+    std::vector<int32_t> finalTurns;
+    std::vector<int32_t> finalMoney;    // [g * players + seat]
+    std::vector<uint8_t> finalSets;
+
+    // A pile as shuffleTop sees it, so decks deal exactly as the engine's
+    struct PileView {
+        CardId* cards;
+        size_t count;
+        size_t size() const { return count; }
+        CardId& operator[](size_t i) { return cards[i]; }
+    };
+
+    size_t seatIndex(int seat, size_t g) const { return seat * stride + g; }
+    size_t colorIndex(int seat, int color, size_t g) const { return (seat * NUM_COLORS + color) * stride + g; }
+    CardId* hand(int seat, size_t g) { return &handCards[seatIndex(seat, g) * MAX_HAND]; }
+
+    // greedyMove's view of one game
+    struct View {
+        const BasicBatchSimulator& sim;
+        size_t g;
+        int self;
+        int opponent;
+
+        GamePhase phase() const { return sim.phase[g]; }
+        size_t handSize() const { return sim.handSize[sim.seatIndex(self, g)]; }
+        CardId hand(size_t i) const { return sim.handCards[sim.seatIndex(self, g) * MAX_HAND + i]; }
+        int setCount(PropertyColor color) const {
+            size_t lane = sim.colorIndex(self, int(color), g);
+            return sim.real[lane] + sim.wild[lane];
+        }
+        bool isListed(PropertyColor color) const { return sim.listed[sim.colorIndex(self, int(color), g)]; }
+        bool opponentComplete(PropertyColor color) const { return sim.complete[sim.colorIndex(opponent, int(color), g)]; }
+        int opponentCount(PropertyColor color) const { return sim.real[sim.colorIndex(opponent, int(color), g)]; }
+        int rent() const { return sim.rent[sim.seatIndex(self, g)]; }
+        int opponentMoney() const { return sim.money[sim.seatIndex(opponent, g)]; }
+        bool opponentHasJustSayNo() const { return sim.justSayNo[sim.seatIndex(opponent, g)]; }
+    };
+
+    void addToHand(int seat, size_t g, CardId card) {
+        size_t s = seatIndex(seat, g);
+        hand(seat, g)[handSize[s]++] = card;
+        if (cardInfo(card).action == ActionKind::JUST_SAY_NO) justSayNo[s] = 1;
+    }
+
+    CardId removeFromHand(int seat, size_t g, size_t index) {
+        CardId* cards = hand(seat, g);
+        uint8_t& size = handSize[seatIndex(seat, g)];
+        CardId card = cards[index];
+        std::copy(cards + index + 1, cards + size, cards + index);
+        size--;
+        return card;
+    }
+
+    void addProperty(int seat, int color, size_t g) {
+        size_t lane = colorIndex(seat, color, g);
+        real[lane]++;
+        listed[lane] = 1;
+    }
+
+    // Runs the kernel over the first `lanes` lanes
+    void updateSets(size_t lanes) {
+        METRICS_SCOPE(metrics::Phase::BATCH_SETS);
+        lanes = (lanes + 31) / 32 * 32;
+        for (int seat = 0; seat < players; seat++) {
+            const uint8_t* r = &real[colorIndex(seat, 0, 0)];
+            const uint8_t* w = &wild[colorIndex(seat, 0, 0)];
+            const uint8_t* l = &listed[colorIndex(seat, 0, 0)];
+            uint8_t* c = &complete[colorIndex(seat, 0, 0)];
+#ifdef MONOPOLY_HAVE_AVX2_KERNEL
+            if (useAvx2) {
+                batchkernel::updateSetsAvx2(SIZES.data(), r, w, l, c, &completeCount[seatIndex(seat, 0)], &rent[seatIndex(seat, 0)], stride, lanes);
+                continue;
+            }
+#endif
+            batchkernel::updateSetsScalar(SIZES.data(), r, w, l, c, &completeCount[seatIndex(seat, 0)], &rent[seatIndex(seat, 0)], stride, lanes);
+        }
+    }
+
+    // Player::playCard for game g. The set data must be current.
+    bool play(size_t g, const Move& move) {
+        int self = current[g];
+        int opponent = (self + 1) % players;
+        size_t s = seatIndex(self, g), o = seatIndex(opponent, g);
+        if (move.handIndex >= handSize[s]) return false;
+        CardId card = hand(self, g)[move.handIndex];
+        const CardInfo& info = cardInfo(card);
+        int give = int(move.color), take = int(move.take);
+
+        switch (info.type) {
+            case CardType::MONEY:
+                money[s] += info.value;
+                break;
+            case CardType::PROPERTY:
+                if (info.isWild) {
+                    if (!wildAllows(card, move.color)) return false;
+                    wild[colorIndex(self, give, g)]++;
+                } else {
+                    addProperty(self, int(info.color), g);
+                }
+                break;
+            case CardType::RENT: {
+                if (justSayNo[o]) return false;
+                int charged = std::min<int>(rent[s], money[o]);
+                money[s] += charged;
+                money[o] -= charged;
+                break;
+            }
+            case CardType::ACTION:
+                if (info.action == ActionKind::DEAL_BREAKER) {
+                    if (give >= NUM_COLORS || !complete[colorIndex(opponent, give, g)]) return false;
+                    real[colorIndex(self, give, g)] = real[colorIndex(opponent, give, g)];
+                    listed[colorIndex(self, give, g)] = 1;
+                    real[colorIndex(opponent, give, g)] = 0;
+                    listed[colorIndex(opponent, give, g)] = 0;
+                }
+                else if (info.action == ActionKind::SLY_DEAL) {
+                    if (give >= NUM_COLORS || !real[colorIndex(opponent, give, g)]) return false;
+                    real[colorIndex(opponent, give, g)]--;
+                    addProperty(self, give, g);
+                }
+                else if (info.action == ActionKind::FORCED_DEAL) {
+                    if (give >= NUM_COLORS || take >= NUM_COLORS || !real[colorIndex(self, give, g)] ||
+                        !real[colorIndex(opponent, take, g)]) return false;
+                    real[colorIndex(self, give, g)]--;
+                    addProperty(opponent, give, g);
+                    real[colorIndex(opponent, take, g)]--;
+                    addProperty(self, take, g);
+                }
+                break;
+            default:
+                return false;
+        }
+
+        removeFromHand(self, g, move.handIndex);
+        if (info.action == ActionKind::JUST_SAY_NO) justSayNo[s] = 0;
+        return true;
+    }
+
+    void reshuffle(size_t g) {
+        if (drawCount[g] || !discardCount[g]) return;
+        std::copy_n(&discardCards[g * NUM_CARDS], discardCount[g], &drawCards[g * NUM_CARDS]);
+        drawCount[g] = discardCount[g];
+        discardCount[g] = 0;
+    }
+
+    // The engine's drawCard: a random card of the pile is swapped to the top
+    // and taken
+    CardId draw(size_t g) {
+        PileView pile{&drawCards[g * NUM_CARDS], drawCount[g]};
+        shuffleTop(pile, rng[g]);
+        return drawCards[g * NUM_CARDS + --drawCount[g]];
+    }
+
+    bool checkWin(size_t g) {
+        if (completeCount[seatIndex(current[g], g)] < Rules::SETS_TO_WIN) return false;
+        winner[g] = int8_t(current[g]);
+        phase[g] = GamePhase::OVER;
+        return true;
+    }
+
+    bool isStalemate(size_t g) const {
+        if (drawCount[g] || discardCount[g]) return false;
+        for (int seat = 0; seat < players; seat++) {
+            if (handSize[seatIndex(seat, g)]) return false;
+        }
+        return true;
+    }
+
+    // MonopolyDealGame::beginTurn
+    void beginTurn(size_t g) {
+        while (true) {
+            if (maxTurns > 0 && turns[g] >= maxTurns) {
+                phase[g] = GamePhase::OVER;
+                return;
+            }
+            int self = current[g];
+            turns[g]++;
+            plays[g] = 0;
+            for (int i = 0; i < Rules::DRAWS_PER_TURN; i++) {
+                reshuffle(g);
+                if (!drawCount[g]) break;
+                addToHand(self, g, draw(g));
+            }
+            if (handSize[seatIndex(self, g)]) {
+                phase[g] = GamePhase::PLAY;
+                return;
+            }
+            if (checkWin(g)) return;
+            if (isStalemate(g)) {
+                phase[g] = GamePhase::OVER;
+                return;
+            }
+            current[g] = uint8_t((self + 1) % players);
+        }
+    }
+
+    void endTurn(size_t g) {
+        current[g] = uint8_t((current[g] + 1) % players);
+        beginTurn(g);
+    }
+
+    void endPlayPhase(size_t g) {
+        if (checkWin(g)) return;
+        if (handSize[seatIndex(current[g], g)] > Rules::HAND_LIMIT) {
+            phase[g] = GamePhase::DISCARD;
+            return;
+        }
+        endTurn(g);
+    }
+
+    // The first card of the highest rank; the hand is not empty
+    static size_t firstBest(const CardId* cards, size_t count, const uint8_t* rank) {
+        size_t best = 0;
+        int bestRank = rank[detail::GREEDY_KIND[cards[0]]];
+        for (size_t i = 1; i < count; i++) {
+            int r = rank[detail::GREEDY_KIND[cards[i]]];
+            if (r > bestRank) {
+                bestRank = r;
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    // greedyMove's Sly Deal target, or -1 when there is nothing to take
+    int slyTarget(size_t g, int self, int opponent) const {
+        int target = -1;
+        for (int c = 0; c < NUM_COLORS; c++) {
+            if (!real[colorIndex(opponent, c, g)]) continue;
+            if (target < 0) target = c;
+            if (real[colorIndex(self, c, g)] + wild[colorIndex(self, c, g)] + 1 == SET_SIZES[c]) return c;
+        }
+        return target;
+    }
+
+    // greedyMove in the play phase, without its per-card branches: the rank
+    // of every kind of card is settled once from the table, and only the
+    // chosen card's color is worked out
+    Move greedyPlay(size_t g, int self, int opponent) const {
+        size_t s = seatIndex(self, g), o = seatIndex(opponent, g);
+        const CardId* cards = &handCards[s * MAX_HAND];
+        if (!handSize[s]) return Move::endTurn();
+
+        uint8_t rank[detail::GREEDY_KINDS] = {0, 7, 6, 5, 4, 3, 2};
+        if (!completeCount[o]) rank[detail::GREEDY_DEAL_BREAKER] = 0;
+        if (justSayNo[o] || !rent[s] || !money[o]) rank[detail::GREEDY_RENT] = 0;
+        size_t best = firstBest(cards, handSize[s], rank);
+        int target = -1;
+        if (detail::GREEDY_KIND[cards[best]] == detail::GREEDY_SLY_DEAL && (target = slyTarget(g, self, opponent)) < 0) {
+            rank[detail::GREEDY_SLY_DEAL] = 0;
+            best = firstBest(cards, handSize[s], rank);
+        }
+
+        uint8_t kind = detail::GREEDY_KIND[cards[best]];
+        if (!rank[kind]) return Move::endTurn();
+        Move move = Move::play(best);
+        if (kind == detail::GREEDY_WILD) return greedyMove(View{*this, g, self, opponent});
+        if (kind == detail::GREEDY_SLY_DEAL) move.color = PropertyColor(target);
+        if (kind == detail::GREEDY_DEAL_BREAKER) {
+            int c = 0;
+            while (!complete[colorIndex(opponent, c, g)]) c++;
+            move.color = PropertyColor(c);
+        }
+        return move;
+    }
+
+    // One decision in game g, as MonopolyDealGame::applyMove
+    void decide(size_t g) {
+        int self = current[g];
+        Move move = phase[g] == GamePhase::DISCARD ? greedyMove(View{*this, g, self, (self + 1) % players})
+                                                    : greedyPlay(g, self, (self + 1) % players);
+        size_t s = seatIndex(self, g);
+        if (phase[g] == GamePhase::DISCARD) {
+            CardId card = removeFromHand(self, g, move.handIndex);
+            discardCards[g * NUM_CARDS + discardCount[g]++] = card;
+            if (handSize[s] <= Rules::HAND_LIMIT) pending[g] = END_TURN;
+        }
+        else if (move.type == MoveType::END_TURN) {
+            pending[g] = END_PLAY;
+        }
+        else if (play(g, move) && (++plays[g] >= Rules::PLAYS_PER_TURN || !handSize[s])) {
+            pending[g] = END_PLAY;
+        }
+    }
+
+    // Copies everything in lane `from` to lane `to`
+    void moveLane(size_t from, size_t to) {
+        gameOf[to] = gameOf[from];
+        rng[to] = rng[from];
+        current[to] = current[from];
+        phase[to] = phase[from];
+        plays[to] = plays[from];
+        winner[to] = winner[from];
+        turns[to] = turns[from];
+        pending[to] = pending[from];
+        drawCount[to] = drawCount[from];
+        discardCount[to] = discardCount[from];
+        std::copy_n(&drawCards[from * NUM_CARDS], drawCount[from], &drawCards[to * NUM_CARDS]);
+        std::copy_n(&discardCards[from * NUM_CARDS], discardCount[from], &discardCards[to * NUM_CARDS]);
+        for (int seat = 0; seat < players; seat++) {
+            size_t a = seatIndex(seat, from), b = seatIndex(seat, to);
+            std::copy_n(hand(seat, from), handSize[a], hand(seat, to));
+            handSize[b] = handSize[a];
+            money[b] = money[a];
+            justSayNo[b] = justSayNo[a];
+            completeCount[b] = completeCount[a];
+            rent[b] = rent[a];
+            for (int c = 0; c < NUM_COLORS; c++) {
+                size_t x = colorIndex(seat, c, from), y = colorIndex(seat, c, to);
+                real[y] = real[x];
+                wild[y] = wild[x];
+                listed[y] = listed[x];
+                complete[y] = complete[x];
+            }
+        }
+    }
+
+    // Saves the results of the finished game in `lane`, then moves the last
+    // running game into it
+    void retire(size_t lane) {
+        size_t g = gameOf[lane];
+        finalWinner[g] = winner[lane];
+        finalTurns[g] = turns[lane];
+        for (int seat = 0; seat < players; seat++) {
+            finalMoney[g * players + seat] = money[seatIndex(seat, lane)];
+            finalSets[g * players + seat] = completeCount[seatIndex(seat, lane)];
+        }
+        if (lane != --active) moveLane(active, lane);
+    }
+
+public:
+    // One game per seed, dealt exactly as BasicMonopolyDealGame<Rules>(names, seed)
+    BasicBatchSimulator(const std::vector<uint64_t>& seeds, int players = 2, int maxTurns = 1000,
+                   Kernel kernel = Kernel::AUTO)
+        : games(seeds.size()), stride((seeds.size() + 31) / 32 * 32), players(players), maxTurns(maxTurns) {
+        // AVX2 is only used where the CPU has it, even when asked for
+        useAvx2 = kernel != Kernel::SCALAR && batchkernel::cpuHasAvx2();
+        gameOf.resize(games);
+        rng.resize(games);
+        current.assign(games, 0);
+        phase.assign(games, GamePhase::NOT_STARTED);
+        plays.assign(games, 0);
+        winner.assign(games, -1);
+        turns.assign(games, 0);
+        drawCards.assign(games * NUM_CARDS, 0);
+        drawCount.assign(games, 0);
+        discardCards.assign(games * NUM_CARDS, 0);
+        discardCount.assign(games, 0);
+        handCards.assign(players * stride * MAX_HAND, 0);
+        handSize.assign(players * stride, 0);
+        money.assign(players * stride, 0);
+        justSayNo.assign(players * stride, 0);
+        completeCount.assign(players * stride, 0);
+        rent.assign(players * stride, 0);
+        real.assign(players * NUM_COLORS * stride, 0);
+        wild.assign(players * NUM_COLORS * stride, 0);
+        listed.assign(players * NUM_COLORS * stride, 0);
+        complete.assign(players * NUM_COLORS * stride, 0);
+        pending.assign(games, NOTHING);
+        finalWinner.assign(games, -1);
+        finalTurns.assign(games, 0);
+        finalMoney.assign(games * players, 0);
+        finalSets.assign(games * players, 0);
+
+        for (size_t g = 0; g < games; g++) {
+            rng[g].reseed(seeds[g]);
+            uint8_t& count = drawCount[g];
+            for (int id = 0; id < NUM_CARDS; id++) {
+                if (Rules::inDeck(CardId(id))) drawCards[g * NUM_CARDS + count++] = CardId(id);
+            }
+            for (int i = 0; i < Rules::STARTING_CARDS; i++) {
+                for (int seat = 0; seat < players; seat++) addToHand(seat, g, draw(g));
+            }
+        }
+    }
+
+    bool usesAvx2() const { return useAvx2; }
+
+    // Plays every game to the end. The kernel runs once a step, after the
+    // decisions: ending turns and drawing never touch a table, so what it
+    // found still holds for the next step's decisions.
+    void run() {
+        active = games;
+        for (size_t g = 0; g < games; g++) gameOf[g] = uint32_t(g);
+        updateSets(active);
+        for (size_t g = 0; g < active;) {
+            beginTurn(g);
+            if (phase[g] == GamePhase::OVER) retire(g);
+            else g++;
+        }
+        while (active) {
+            {
+                METRICS_SCOPE(metrics::Phase::BATCH_DECIDE);
+                for (size_t g = 0; g < active; g++) decide(g);
+            }
+
+            updateSets(active);
+            METRICS_SCOPE(metrics::Phase::BATCH_ADVANCE);
+            // A retired lane takes the last running game, whose turn end is
+            // still pending, so the same lane is looked at again
+            for (size_t g = 0; g < active;) {
+                if (pending[g] == END_PLAY) endPlayPhase(g);
+                else if (pending[g] == END_TURN) endTurn(g);
+                pending[g] = NOTHING;
+                if (phase[g] == GamePhase::OVER) retire(g);
+                else g++;
+            }
+        }
+    }
+
+    // Runs only the set kernel over every lane, for timing it
+    void refreshSets() { updateSets(stride); }
+
+    size_t size() const { return games; }
+    // Results of game g, once run() has returned
+    int getWinner(size_t g) const { return finalWinner[g]; }
+    int getTurnCount(size_t g) const { return finalTurns[g]; }
+    int getMoney(size_t g, int seat) const { return finalMoney[g * players + seat]; }
+    int getCompleteSetCount(size_t g, int seat) const { return finalSets[g * players + seat]; }
+};
+
+using BatchSimulator = BasicBatchSimulator<StandardRules>;
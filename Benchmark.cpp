@@ -0,0 +1,1142 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <new>
+// Counts every heap allocation, so benchmarks can report allocs/op
+#define MONOPOLY_COUNT_ALLOCATIONS
+#include "Allocations.h"
+#include "Batch.h"
+#include "Cards.h"
+#include "Endgame.h"
+#include "Tableau.h"
+#include "Terminal.h"
+#include "Mcts.h"
+#include "MonopolyDeal.h"
+#include "Policies.h"
+#include "Snapshot.h"
+#include "TranspositionTable.h"
+#include "WildSolver.h"
+
+using namespace std;
+
+// One line of the machine-readable report
+struct BenchResult {
+    string name;
+    double nsPerOp;
+    double allocsPerOp;
+};
+
+static vector<BenchResult> results;
+
+static void record(const string& name, double ns, double allocs) {
+    results.push_back({name, ns, allocs});
+}
+
+static bool writeJson(const string& path) {
+    ofstream out(path);
+    out << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"ns_per_op\": " << fixed << setprecision(3) << r.nsPerOp
+            << ", \"ops_per_sec\": " << setprecision(1) << 1e9 / r.nsPerOp
+            << ", \"allocs_per_op\": " << setprecision(3) << r.allocsPerOp << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    return bool(out);
+}
+
+// The map-based layout Player used before PropertyTableau, kept as the baseline
+struct MapTableau {
+    map<PropertyColor, vector<CardId>> properties;
+    vector<WildCard> wildCards;
+
+    bool isCompleteSet(PropertyColor color) const {
+        auto it = PROPERTY_SETS.find(color);
+        if (it == PROPERTY_SETS.end()) return false;
+
+        int count = properties.count(color) ? properties.at(color).size() : 0;
+        for (const auto& wild : wildCards) {
+            if (wild.color == color) count++;
+        }
+        return count >= it->second.first;
+    }
+
+    vector<PropertyColor> getCompleteSets() const {
+        vector<PropertyColor> complete;
+        for (const auto& [color, _] : PROPERTY_SETS) {
+            if (isCompleteSet(color)) complete.push_back(color);
+        }
+        return complete;
+    }
+
+    int rent() const {
+        int rent = 0;
+        for (const auto& [color, _] : properties) {
+            if (isCompleteSet(color)) rent += PROPERTY_SETS.at(color).first * 2;
+        }
+        return rent;
+    }
+};
+
+struct Timing {
+    double ns;
+    double allocs;
+};
+
+// Runs body(0..iterations-1) and returns the cost of one call
+template <class F>
+Timing timeOps(long iterations, F&& body) {
+    uint64_t allocsBefore = allocations::processCount();
+    auto start = chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i++) body(i);
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    return {ns / iterations, double(allocations::processCount() - allocsBefore) / iterations};
+}
+
+// Like timeOps, for operations that use up their input: prepare(i) resets
+// item i outside the clock, then body(i) runs on every item of the batch
+template <class P, class F>
+Timing timeBatches(int rounds, size_t batch, P&& prepare, F&& body) {
+    double ns = 0;
+    uint64_t allocs = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < batch; i++) prepare(i);
+        uint64_t allocsBefore = allocations::processCount();
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < batch; i++) body(i);
+        ns += chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        allocs += allocations::processCount() - allocsBefore;
+    }
+    double ops = double(rounds) * batch;
+    return {ns / ops, allocs / ops};
+}
+
+template <class F>
+double nsPerOp(long iterations, F&& body) {
+    return timeOps(iterations, body).ns;
+}
+
+static void report(const string& name, double before, double after) {
+    cout << left << setw(26) << name << right << fixed << setprecision(2)
+         << setw(10) << before << " ns" << setw(10) << after << " ns"
+         << setw(9) << before / after << "x\n";
+}
+
+// Compares the map-based set checks with PropertyTableau on the same random tables
+static int benchPropertySets() {
+    const int positions = 1024;
+    const long iterations = 2000000;
+
+    mt19937 rng(42);
+    vector<MapTableau> before(positions);
+    vector<PropertyTableau> after(positions);
+    vector<CardId> props, wilds;
+    for (int id = 0; id < NUM_CARDS; id++) {
+        if (cardInfo(id).type != CardType::PROPERTY) continue;
+        (cardInfo(id).isWild ? wilds : props).push_back(id);
+    }
+
+    for (int p = 0; p < positions; p++) {
+        int cards = uniform_int_distribution<int>(0, 20)(rng);
+        for (int i = 0; i < cards; i++) {
+            CardId id = props[uniform_int_distribution<size_t>(0, props.size() - 1)(rng)];
+            before[p].properties[cardInfo(id).color].push_back(id);
+            after[p].add(id, cardInfo(id).color);
+        }
+        int wildCount = uniform_int_distribution<int>(0, 2)(rng);
+        for (int i = 0; i < wildCount; i++) {
+            const CardInfo& wild = cardInfo(wilds[i]);
+            PropertyColor color = wild.wildColors[uniform_int_distribution<int>(0, 1)(rng)];
+            before[p].wildCards.push_back({wilds[i], color});
+            after[p].addWild(wilds[i], color);
+        }
+        if (before[p].getCompleteSets().size() != size_t(after[p].completeSets()) ||
+            before[p].rent() != after[p].rent()) {
+            cerr << "property set mismatch at position " << p << "\n";
+            return 1;
+        }
+    }
+
+    long sink = 0;
+    cout << left << setw(26) << "operation" << right << setw(13) << "map" << setw(13) << "tableau" << setw(10) << "gain" << "\n";
+
+    Timing mapComplete = timeOps(iterations, [&](long i) {
+        sink += before[i % positions].isCompleteSet(PropertyColor(i % NUM_COLORS));
+    });
+    Timing tableauComplete = timeOps(iterations, [&](long i) {
+        sink += after[i % positions].isComplete(PropertyColor(i % NUM_COLORS));
+    });
+    report("isCompleteSet", mapComplete.ns, tableauComplete.ns);
+    record("map.isCompleteSet", mapComplete.ns, mapComplete.allocs);
+    record("tableau.isComplete", tableauComplete.ns, tableauComplete.allocs);
+
+    Timing mapWin = timeOps(iterations, [&](long i) {
+        sink += before[i % positions].getCompleteSets().size() >= 3;
+    });
+    Timing tableauWin = timeOps(iterations, [&](long i) {
+        sink += after[i % positions].completeSets() >= 3;
+    });
+    report("win check (3 sets)", mapWin.ns, tableauWin.ns);
+    record("map.winCheck", mapWin.ns, mapWin.allocs);
+    record("tableau.winCheck", tableauWin.ns, tableauWin.allocs);
+
+    Timing mapRent = timeOps(iterations, [&](long i) {
+        sink += before[i % positions].rent();
+    });
+    Timing tableauRent = timeOps(iterations, [&](long i) {
+        sink += after[i % positions].rent();
+    });
+    report("rent", mapRent.ns, tableauRent.ns);
+    record("map.rent", mapRent.ns, mapRent.allocs);
+    record("tableau.rent", tableauRent.ns, tableauRent.allocs);
+
+    cout << "(checksum " << sink << ")\n";
+    return 0;
+}
+
+// Tries every color for every single wild card
+static WildAssignment bruteForceWilds(const WildProblem& problem) {
+    int kinds[NUM_WILDS], count = 0;
+    for (int k = 0; k < NUM_WILD_KINDS; k++) {
+        for (int i = 0; i < problem.wilds[k]; i++) kinds[count++] = k;
+    }
+    WildAssignment best{};
+    best.completeSets = -1;
+    for (uint32_t sides = 0; sides < (1u << count); sides++) {
+        int totals[NUM_COLORS];
+        copy(begin(problem.fixed), end(problem.fixed), totals);
+        for (int i = 0; i < count; i++) totals[int(wildKindColor(kinds[i], (sides >> i) & 1))]++;
+        WildAssignment here{};
+        for (int c = 0; c < NUM_COLORS; c++) {
+            if (totals[c] < SET_SIZES[c]) continue;
+            here.completeSets++;
+            if (problem.listed & (1u << c)) here.rent += 2 * SET_SIZES[c];
+        }
+        if (here.completeSets > best.completeSets || (here.completeSets == best.completeSets && here.rent > best.rent)) best = here;
+    }
+    return best;
+}
+
+// Checks solveWilds against brute force on random tables and hands
+static int benchWilds() {
+    const int problems = 4096;
+    const long iterations = 4000000;
+
+    mt19937 rng(12);
+    vector<WildProblem> cases(problems);
+    for (auto& problem : cases) {
+        for (int c = 0; c < NUM_COLORS; c++) {
+            problem.fixed[c] = uint8_t(uniform_int_distribution<int>(0, SET_SIZES[c] + 1)(rng));
+            if (uniform_int_distribution<int>(0, 1)(rng)) problem.listed |= uint16_t(1u << c);
+        }
+        for (int k = 0; k < NUM_WILD_KINDS; k++) {
+            problem.wilds[k] = uint8_t(uniform_int_distribution<int>(0, MAX_WILD_COPIES)(rng));
+        }
+    }
+    for (int p = 0; p < problems; p++) {
+        WildAssignment solved = solveWilds(cases[p]), expected = bruteForceWilds(cases[p]);
+        bool placed = true;
+        for (int k = 0; k < NUM_WILD_KINDS; k++) placed &= solved.toFirst[k] <= cases[p].wilds[k];
+        if (!placed || solved.completeSets != expected.completeSets || solved.rent != expected.rent) {
+            cerr << "wild assignment " << p << " differs from brute force\n";
+            return 1;
+        }
+    }
+
+    long sink = 0;
+    cout << "\n" << left << setw(26) << "wild assignment" << right << setw(13) << "brute force" << setw(13) << "solver" << setw(10) << "gain" << "\n";
+    Timing brute = timeOps(iterations / 16, [&](long i) { sink += bruteForceWilds(cases[i % problems]).rent; });
+    Timing solver = timeOps(iterations, [&](long i) { sink += solveWilds(cases[i % problems]).rent; });
+    report("solve", brute.ns, solver.ns);
+    record("wilds.bruteForce", brute.ns, brute.allocs);
+    record("wilds.solve", solver.ns, solver.allocs);
+    cout << "(" << problems << " random problems match brute force, checksum " << sink << ")\n";
+    return 0;
+}
+
+// Decision points from random games, used by the search benchmarks
+static vector<MonopolyDealGame> samplePositions(int games) {
+    vector<MonopolyDealGame> positions;
+    vector<string> names = {"P1", "P2"};
+    Xoshiro256 rng(7);
+    MoveList moves;
+    for (int g = 0; g < games; g++) {
+        MonopolyDealGame game(names, g);
+        game.setMaxTurns(200);
+        game.start();
+        while (!game.isOver()) {
+            game.generateMoves(moves);
+            if (game.getPhase() == GamePhase::PLAY) positions.push_back(game);
+            if (!game.applyMove(moves[rng.below(moves.size())])) {
+                cerr << "generated move was rejected\n";
+                return {};
+            }
+        }
+    }
+    return positions;
+}
+
+// Legal move generation over positions sampled from random games
+static int benchMoveGeneration() {
+    const int games = 200;
+    const long iterations = 2000000;
+
+    vector<MonopolyDealGame> positions = samplePositions(games);
+    if (positions.empty()) return 1;
+    MoveList moves;
+
+    long generated = 0;
+    Timing timing = timeOps(iterations, [&](long i) {
+        positions[i % positions.size()].generateMoves(moves);
+        generated += moves.size();
+    });
+    double ns = timing.ns;
+    record("generateMoves", ns, timing.allocs);
+
+    cout << "\nmove generation over " << positions.size() << " positions\n";
+    cout << fixed << setprecision(2);
+    cout << "  ns/position:      " << ns << "\n";
+    cout << "  moves/position:   " << double(generated) / iterations << "\n";
+    cout << "  moves/sec:        " << setprecision(0) << generated / (ns * iterations) * 1e9 << "\n";
+    return 0;
+}
+
+static void show(const string& name, Timing timing) {
+    record(name, timing.ns, timing.allocs);
+    cout << left << setw(32) << name << right << fixed << setprecision(2)
+         << setw(12) << timing.ns << " ns" << setw(10) << timing.allocs << " allocs\n";
+}
+
+// Which playCard benchmark a move belongs to
+static int playCategory(CardId card) {
+    const CardInfo& info = cardInfo(card);
+    if (info.type == CardType::MONEY) return 0;
+    if (info.type == CardType::PROPERTY) return info.isWild ? 2 : 1;
+    if (info.type == CardType::RENT) return 3;
+    return 3 + int(info.action);
+}
+
+// Upper critical value of chi-square with `df` degrees of freedom at z
+// standard deviations (Wilson-Hilferty)
+static double chiSquareCritical(int df, double z) {
+    double k = 2.0 / (9.0 * df);
+    return df * pow(1 - k + z * sqrt(k), 3);
+}
+
+static double chiSquare(const vector<long>& observed, double expected) {
+    double sum = 0;
+    for (long count : observed) sum += (count - expected) * (count - expected) / expected;
+    return sum;
+}
+
+// Lazy draws against shuffling the whole deck first: the same cards in the
+// same order, dealt without bias, and what each costs per card drawn
+static int benchDeck() {
+    const int checks = 2000;
+    const int deals = 200000;
+    const vector<string> names = {"P1", "P2"};
+    // 1 in 10^4 for each test, with fixed seeds so a pass is repeatable
+    const double z = 3.72;
+
+    cout << "\ndeck: lazy Fisher-Yates draws\n";
+
+    // Drawing every card with shuffleTop is shuffleCards read from the top
+    CardPile full;
+    MonopolyDealGame::initializeDeck(full);
+    for (int s = 0; s < checks; s++) {
+        CardPile eager = full, lazy = full;
+        Xoshiro256 eagerRng(deriveSeed(17, s)), lazyRng(deriveSeed(17, s));
+        shuffleCards(eager, eagerRng);
+        while (!lazy.empty()) {
+            shuffleTop(lazy, lazyRng);
+            if (lazy.back() != eager[lazy.size() - 1]) {
+                cerr << "seed " << s << ": lazy draw " << full.size() - lazy.size() << " differs from the shuffled deck\n";
+                return 1;
+            }
+            lazy.pop_back();
+        }
+        if (!(eagerRng == lazyRng)) {
+            cerr << "seed " << s << ": lazy draws used the RNG differently\n";
+            return 1;
+        }
+    }
+    cout << "  " << checks << " full decks drawn lazily match shuffleCards\n";
+
+    // Each of the 10 cards dealt by the engine is uniform over the deck
+    const int dealt = 2 * 5;
+    vector<vector<long>> byPosition(dealt, vector<long>(NUM_CARDS));
+    for (int d = 0; d < deals; d++) {
+        MonopolyDealGame game(names, deriveSeed(18, d));
+        for (int p = 0; p < 2; p++) {
+            for (int i = 0; i < 5; i++) byPosition[i * 2 + p][game.getPlayers()[p].getHand()[i]]++;
+        }
+    }
+    double worst = 0;
+    for (const auto& counts : byPosition) worst = max(worst, chiSquare(counts, double(deals) / NUM_CARDS));
+    double critical = chiSquareCritical(NUM_CARDS - 1, z);
+    cout << fixed << setprecision(1) << "  dealt card by position, " << deals << " deals: worst chi-square " << worst
+         << " (df " << NUM_CARDS - 1 << ", limit " << critical << ")\n";
+    if (worst > critical) {
+        cerr << "the deal is biased\n";
+        return 1;
+    }
+
+    // And the orders as a whole: every order of a small pile equally often
+    const int orders = 24;
+    vector<long> byOrder(orders);
+    Xoshiro256 rng(19);
+    for (int d = 0; d < deals; d++) {
+        CardPile pile;
+        for (int i = 0; i < 4; i++) pile.push_back(CardId(i));
+        int code = 0;
+        for (int left = 4; left > 0; left--) {
+            shuffleTop(pile, rng);
+            int rank = 0;
+            for (size_t i = 0; i + 1 < pile.size(); i++) rank += pile[i] < pile.back();
+            code = code * left + rank;
+            pile.pop_back();
+        }
+        byOrder[code]++;
+    }
+    double orderStat = chiSquare(byOrder, double(deals) / orders);
+    critical = chiSquareCritical(orders - 1, z);
+    cout << "  orders of 4 cards, " << deals << " draws: chi-square " << orderStat << " (df " << orders - 1
+         << ", limit " << critical << ")\n";
+    if (orderStat > critical) {
+        cerr << "lazy draws favor some orders\n";
+        return 1;
+    }
+
+    // Cost per card drawn. A game deals 10 and then draws 2 a turn, so the
+    // whole-deck shuffle up front is mostly spent on cards never reached.
+    const int rounds = 200;
+    const size_t batch = 1024;
+    vector<CardPile> decks(batch);
+    auto refill = [&](size_t i) { decks[i] = full; };
+    long sink = 0;
+    Timing eagerDeck = timeBatches(rounds, batch, refill, [&](size_t i) {
+        shuffleCards(decks[i], rng);
+        while (!decks[i].empty()) { sink += decks[i].back(); decks[i].pop_back(); }
+    });
+    Timing lazyDeck = timeBatches(rounds, batch, refill, [&](size_t i) {
+        while (!decks[i].empty()) { shuffleTop(decks[i], rng); sink += decks[i].back(); decks[i].pop_back(); }
+    });
+    Timing eagerDeal = timeBatches(rounds, batch, refill, [&](size_t i) {
+        shuffleCards(decks[i], rng);
+        for (int c = 0; c < dealt; c++) { sink += decks[i].back(); decks[i].pop_back(); }
+    });
+    Timing lazyDeal = timeBatches(rounds, batch, refill, [&](size_t i) {
+        for (int c = 0; c < dealt; c++) { shuffleTop(decks[i], rng); sink += decks[i].back(); decks[i].pop_back(); }
+    });
+
+    cout << left << setw(26) << "drawing" << right << setw(13) << "eager" << setw(13) << "lazy" << setw(10) << "gain" << "\n";
+    report("whole deck, per card", eagerDeck.ns / full.size(), lazyDeck.ns / full.size());
+    report("opening deal, per card", eagerDeal.ns / dealt, lazyDeal.ns / dealt);
+    cout << "  draws/sec, lazy:        " << setprecision(0) << 1e9 * full.size() / lazyDeck.ns << "\n";
+    cout << "  opening deals/sec:      " << 1e9 / eagerDeal.ns << " eager, " << 1e9 / lazyDeal.ns << " lazy\n";
+    cout << "(checksum " << sink << ")\n";
+    record("draw (whole deck, eager)", eagerDeck.ns / full.size(), eagerDeck.allocs / full.size());
+    record("draw (whole deck, lazy)", lazyDeck.ns / full.size(), lazyDeck.allocs / full.size());
+    record("opening deal (eager)", eagerDeal.ns, eagerDeal.allocs);
+    record("opening deal (lazy)", lazyDeal.ns, lazyDeal.allocs);
+    return 0;
+}
+
+// The engine's hot paths one at a time: setting up a game, every kind of
+// play, the set checks and whole games between random policies
+static int benchEngine() {
+    const int rounds = 200;
+    const size_t batch = 1024;
+    const vector<string> names = {"P1", "P2"};
+    long sink = 0;
+
+    cout << "\nengine hot paths\n";
+    cout << left << setw(32) << "operation" << right << setw(15) << "time" << setw(17) << "allocations\n";
+
+    vector<CardPile> decks(batch);
+    show("initializeDeck", timeBatches(rounds, batch, [&](size_t i) { decks[i].clear(); },
+                                       [&](size_t i) { MonopolyDealGame::initializeDeck(decks[i]); }));
+    Xoshiro256 rng(3);
+    show("shuffleCards", timeOps(rounds * batch, [&](long i) { shuffleCards(decks[i % batch], rng); }));
+
+    // Dealing again hands out 5 more cards each from what is left of the deck
+    const MonopolyDealGame fresh(names, 1);
+    vector<MonopolyDealGame> games(batch, fresh);
+    show("dealInitialCards", timeBatches(rounds, batch, [&](size_t i) { games[i] = fresh; },
+                                         [&](size_t i) { games[i].dealInitialCards(); }));
+    show("new game (deck, deal)", timeOps(rounds * batch / 4, [&](long i) {
+        MonopolyDealGame game(names, i);
+        sink += game.getPlayers()[0].getHand()[0];
+    }));
+
+    // Legal plays from random games, grouped by the card played
+    struct Play {
+        Player self;
+        Player opponent;
+        Move move;
+    };
+    const char* categories[] = {"money", "property", "wild", "rent", "deal breaker", "sly deal", "forced deal",
+                                "just say no"};
+    vector<vector<Play>> plays(size(categories));
+    vector<MonopolyDealGame> positions = samplePositions(300);
+    if (positions.empty()) return 1;
+    MoveList moves;
+    for (const auto& game : positions) {
+        const Player& self = game.getPlayers()[game.getCurrentPlayer()];
+        const Player& opponent = game.getPlayers()[(game.getCurrentPlayer() + 1) % 2];
+        game.generateMoves(moves);
+        for (const Move& move : moves) {
+            if (move.type != MoveType::PLAY) continue;
+            auto& list = plays[playCategory(self.getHand()[move.handIndex])];
+            if (list.size() < batch) list.push_back({self, opponent, move});
+        }
+    }
+    for (size_t c = 0; c < plays.size(); c++) {
+        if (plays[c].empty()) {
+            cerr << "no " << categories[c] << " plays were sampled\n";
+            return 1;
+        }
+        vector<Play> work = plays[c];
+        long applied = 0;
+        Timing timing = timeBatches(rounds, work.size(), [&](size_t i) { work[i] = plays[c][i]; }, [&](size_t i) {
+            applied += work[i].self.playCard(work[i].move, work[i].opponent, nullptr);
+        });
+        if (applied != long(rounds) * long(work.size())) {
+            cerr << "a generated " << categories[c] << " play was rejected\n";
+            return 1;
+        }
+        show(string("playCard (") + categories[c] + ")", timing);
+    }
+
+    vector<const Player*> players;
+    for (const auto& game : positions) {
+        for (const auto& player : game.getPlayers()) players.push_back(&player);
+    }
+    const long lookups = rounds * long(batch) * 10;
+    show("isCompleteSet", timeOps(lookups, [&](long i) {
+        sink += players[i % players.size()]->isCompleteSet(PropertyColor(i % NUM_COLORS));
+    }));
+    show("getCompleteSets", timeOps(lookups / 10, [&](long i) {
+        sink += players[i % players.size()]->getCompleteSets().size();
+    }));
+    show("rent", timeOps(lookups, [&](long i) { sink += players[i % players.size()]->getProperties().rent(); }));
+
+    RandomPolicy first(1), second(2);
+    const long gameCount = 2000;
+    long turns = 0;
+    Timing game = timeOps(gameCount, [&](long g) {
+        MonopolyDealGame match(names, deriveSeed(9, g));
+        first.reseed(deriveSeed(10, g));
+        second.reseed(deriveSeed(11, g));
+        match.setPolicy(0, &first);
+        match.setPolicy(1, &second);
+        sink += match.playGame(1000);
+        turns += match.getTurnCount();
+    });
+    show("random game", game);
+    cout << "  games/sec:        " << fixed << setprecision(0) << 1e9 / game.ns
+         << " (" << setprecision(1) << double(turns) / gameCount << " turns/game)\n";
+
+    // Turns once a game is set up, which must not allocate: monopoly_tests
+    // asserts that, this only times them
+    GreedyPolicy greedy;
+    WeightedPolicy weighted;
+    DecisionPolicy* bots[][2] = {{&first, &second}, {&greedy, &weighted}, {&weighted, &first}};
+    uint64_t turnAllocs = 0;
+    long steadyTurns = 0;
+    double steadyNs = 0;
+    for (long g = 0; g < gameCount; g++) {
+        MonopolyDealGame match(names, deriveSeed(12, g));
+        first.reseed(deriveSeed(13, g));
+        match.setPolicy(0, bots[g % 3][0]);
+        match.setPolicy(1, bots[g % 3][1]);
+        allocations::Scope scope;
+        auto start = chrono::steady_clock::now();
+        sink += match.playGame(1000);
+        steadyNs += chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        turnAllocs += scope.count();
+        steadyTurns += match.getTurnCount();
+    }
+    show("turn (random, greedy, weighted)", {steadyNs / steadyTurns, double(turnAllocs) / steadyTurns});
+    cout << "(checksum " << sink << ")\n";
+    return 0;
+}
+
+// Counts the leaves `depth` moves deep, either walking one game object with
+// make/unmake or copying the game at every node
+static long perftUndo(MonopolyDealGame& game, int depth) {
+    if (depth == 0 || game.isOver()) return 1;
+    MoveList moves;
+    game.generateMoves(moves);
+    long nodes = 0;
+    UndoRecord undo;
+    for (const Move& move : moves) {
+        game.applyMove(move, undo);
+        nodes += perftUndo(game, depth - 1);
+        game.undoMove(undo);
+    }
+    return nodes;
+}
+
+static long perftCopy(const MonopolyDealGame& game, int depth) {
+    if (depth == 0 || game.isOver()) return 1;
+    MoveList moves;
+    game.generateMoves(moves);
+    long nodes = 0;
+    for (const Move& move : moves) {
+        MonopolyDealGame child = game;
+        child.applyMove(move);
+        nodes += perftCopy(child, depth - 1);
+    }
+    return nodes;
+}
+
+// Same walk, but positions already seen through another move order are skipped
+static long perftTransposed(MonopolyDealGame& game, int depth, TranspositionTable& table) {
+    if (depth == 0 || game.isOver()) return 1;
+    if (const TTEntry* entry = table.probe(game.hash())) {
+        if (entry->depth >= depth) return 0;
+    }
+    MoveList moves;
+    game.generateMoves(moves);
+    long nodes = 0;
+    UndoRecord undo;
+    for (const Move& move : moves) {
+        game.applyMove(move, undo);
+        nodes += perftTransposed(game, depth - 1, table);
+        game.undoMove(undo);
+    }
+    table.store(game.hash(), 0.0f, depth, TTBound::EXACT, Move::endTurn());
+    return nodes;
+}
+
+// Checks that undoMove restores every position exactly and that the
+// incremental hash matches one built from scratch, then times tree walks
+static int benchMakeUnmake() {
+    vector<MonopolyDealGame> positions = samplePositions(100);
+    if (positions.empty()) return 1;
+    for (auto& game : positions) game.setObserver(nullptr);
+
+    Xoshiro256 rng(11);
+    MoveList moves;
+    vector<UndoRecord> stack(64);
+    for (size_t p = 0; p < positions.size(); p++) {
+        MonopolyDealGame game = positions[p];
+        const MonopolyDealGame original = game;
+        int depth = 0;
+        while (depth < 64 && !game.isOver()) {
+            game.generateMoves(moves);
+            if (!game.applyMove(moves[rng.below(moves.size())], stack[depth])) {
+                cerr << "generated move was rejected\n";
+                return 1;
+            }
+            depth++;
+            if (game.hash() != game.recomputeHash()) {
+                cerr << "incremental hash drifted at position " << p << "\n";
+                return 1;
+            }
+        }
+        while (depth > 0) game.undoMove(stack[--depth]);
+        if (!game.sameState(original) || game.hash() != original.hash()) {
+            cerr << "undo did not restore position " << p << "\n";
+            return 1;
+        }
+    }
+
+    // Players who mostly pass run the draw pile dry, so these games also
+    // undo reshuffles
+    long reshuffles = 0;
+    UndoRecord undo;
+    for (int g = 0; g < 300; g++) {
+        MonopolyDealGame game({"P1", "P2"}, 1000 + g);
+        game.setMaxTurns(400);
+        game.start();
+        while (!game.isOver()) {
+            game.generateMoves(moves);
+            Move move = rng.below(10) ? moves[moves.size() - 1] : moves[rng.below(moves.size())];
+            MonopolyDealGame before = game;
+            game.applyMove(move, undo);
+            MonopolyDealGame after = game;
+            game.undoMove(undo);
+            if (!game.sameState(before)) {
+                cerr << "undo did not restore game " << g << "\n";
+                return 1;
+            }
+            reshuffles += undo.reshuffleAt >= 0;
+            game = after;
+        }
+    }
+    if (reshuffles == 0) {
+        cerr << "no reshuffle was undone\n";
+        return 1;
+    }
+
+    const int depth = 3;
+    const size_t count = 2000;
+    long undoNodes = 0, copyNodes = 0, transposedNodes = 0;
+    auto start = chrono::steady_clock::now();
+    for (size_t p = 0; p < count; p++) undoNodes += perftUndo(positions[p % positions.size()], depth);
+    double undoSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    for (size_t p = 0; p < count; p++) copyNodes += perftCopy(positions[p % positions.size()], depth);
+    double copySeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    TranspositionTable table(16);
+    for (size_t p = 0; p < count; p++) {
+        table.newSearch();
+        transposedNodes += perftTransposed(positions[p % positions.size()], depth, table);
+    }
+
+    record("perft.makeUnmake.node", undoSeconds * 1e9 / undoNodes, 0);
+    record("perft.copy.node", copySeconds * 1e9 / copyNodes, 0);
+
+    cout << "\nperft depth " << depth << " over " << count << " positions (" << undoNodes << " leaves)\n";
+    cout << fixed << setprecision(0);
+    cout << "  make/unmake:      " << undoNodes / undoSeconds << " nodes/sec\n";
+    cout << "  copy per node:    " << copyNodes / copySeconds << " nodes/sec\n";
+    cout << "  undo record:      " << sizeof(UndoRecord) << " bytes vs " << sizeof(MonopolyDealGame)
+         << "+ bytes per game copy\n";
+    cout << setprecision(1);
+    cout << "  transpositions:   " << 100.0 * (undoNodes - transposedNodes) / undoNodes
+         << "% of leaves skipped, table hit rate " << 100.0 * table.hitRate() << "%\n";
+    return 0;
+}
+
+// MCTS against the random bot, swapping seats every game
+static int benchMcts() {
+    const int games = 20;
+    MctsConfig config;
+    config.playouts = 300;
+    MctsPolicy mcts(config, 5);
+    RandomPolicy random(6);
+
+    int wins = 0, losses = 0;
+    uint64_t allocsBefore = allocations::processCount();
+    for (int g = 0; g < games; g++) {
+        MonopolyDealGame game({"P1", "P2"}, 5000 + g);
+        size_t seat = g % 2;
+        game.setPolicy(seat, &mcts);
+        game.setPolicy(1 - seat, &random);
+        int winner = game.playGame(200);
+        wins += winner == int(seat);
+        losses += winner == int(1 - seat);
+    }
+
+    const MctsSearch& search = mcts.getSearch();
+    record("mcts.playout", 1e9 / search.playoutsPerSecond(),
+           double(allocations::processCount() - allocsBefore) / search.getPlayouts());
+
+    cout << "\nMCTS, " << config.playouts << " playouts/move, vs random over " << games << " games\n";
+    cout << fixed << setprecision(0);
+    cout << "  playouts/sec:     " << search.playoutsPerSecond() << "\n";
+    cout << "  won/lost/drawn:   " << wins << "/" << losses << "/" << games - wins - losses << "\n";
+    if (wins <= losses) {
+        cerr << "MCTS did not beat the random bot\n";
+        return 1;
+    }
+    return 0;
+}
+
+// The first position of each random game where someone is a set from
+// winning, with the player to move still able to play
+static vector<MonopolyDealGame> sampleEndgames(int games) {
+    vector<MonopolyDealGame> positions;
+    MoveList moves;
+    Xoshiro256 rng(21);
+    for (int g = 0; g < games; g++) {
+        MonopolyDealGame game({"P1", "P2"}, deriveSeed(20, g));
+        game.setMaxTurns(200);
+        game.start();
+        while (!game.isOver()) {
+            game.generateMoves(moves);
+            int most = 0;
+            for (const Player& player : game.getPlayers()) most = max(most, player.getCompleteSetCount());
+            if (game.getPhase() == GamePhase::PLAY && most == StandardRules::SETS_TO_WIN - 1) {
+                positions.push_back(game);
+                break;
+            }
+            game.applyMove(moves[rng.below(moves.size())]);
+        }
+    }
+    return positions;
+}
+
+// The expectimax endgame solver: checked against plain expectimax (no memo,
+// no pruning) at a short horizon, then timed with a budget per position
+static int benchEndgame() {
+    vector<MonopolyDealGame> positions = sampleEndgames(200);
+    const int checked = 8;
+
+    EndgameConfig exact;
+    exact.seconds = 60;
+    exact.maxHorizon = 2;
+    EndgameConfig plain = exact;
+    plain.memo = plain.pruning = false;
+    EndgameSolver fast(exact), reference(plain);
+    // Plain expectimax grows too fast for big hands, so check the small ones
+    int done = 0;
+    for (size_t i = 0; i < positions.size() && done < checked; i++) {
+        if (positions[i].getPlayers()[positions[i].getCurrentPlayer()].getHand().size() > 4) continue;
+        done++;
+        EndgameResult a = fast.solve(positions[i]), b = reference.solve(positions[i]);
+        if (fabs(a.score - b.score) > 1e-4) {
+            cerr << "endgame " << i << ": solver says " << a.score << ", plain expectimax " << b.score << "\n";
+            return 1;
+        }
+    }
+    // The solver only knows two seats; a bigger table is refused unsearched
+    MonopolyDealGame table({"P1", "P2", "P3", "P4"}, deriveSeed(20, 0));
+    table.start();
+    if (fast.solve(table).horizon != 0) {
+        cerr << "the endgame solver searched a 4-player game\n";
+        return 1;
+    }
+
+    EndgameConfig config;
+    config.seconds = 0.02;
+    EndgameSolver solver(config);
+    int exactCount = 0, exactWins = 0;
+    long horizons = 0;
+    double scores = 0;
+    uint64_t allocsBefore = allocations::processCount();
+    for (const auto& position : positions) {
+        EndgameResult result = solver.solve(position);
+        horizons += result.horizon;
+        if (result.exact) {
+            exactCount++;
+            exactWins += result.score >= 1;
+        } else {
+            scores += result.score;
+        }
+    }
+    double allocs = double(allocations::processCount() - allocsBefore) / solver.getNodes();
+    record("endgame.state", 1e9 / solver.statesPerSecond(), allocs);
+
+    cout << "\nendgame solver, " << positions.size() << " positions a set from winning, "
+         << config.seconds * 1000 << " ms each\n";
+    cout << "  " << done << " positions match plain expectimax at a 2-turn horizon ("
+         << fast.getNodes() << " vs " << reference.getNodes() << " states)\n";
+    cout << fixed << setprecision(0);
+    cout << "  states/sec:       " << solver.statesPerSecond() << "\n";
+    cout << setprecision(1);
+    cout << "  memo hit rate:    " << 100 * solver.getMemo().hitRate() << "% of " << solver.getMemo().probeCount() << " probes\n";
+    cout << "  cutoffs:          " << solver.getCutoffs() << "\n";
+    cout << "  mean horizon:     " << double(horizons) / positions.size() << " turns\n";
+    cout << "  solved exactly:   " << exactCount << " of " << positions.size() << " (" << exactWins
+         << " forced wins, " << exactCount - exactWins << " forced losses or exact odds)\n";
+    cout << setprecision(3) << "  horizon score:    " << scores / max<size_t>(positions.size() - exactCount, 1)
+         << " mean for the rest, undecided lines counting half\n";
+    return 0;
+}
+
+// Snapshots of sampled positions: each must restore into a fresh game
+// identical to its source and play on identically, and damaged ones must be
+// refused without touching the game
+static int benchSnapshot() {
+    vector<MonopolyDealGame> positions = samplePositions(100);
+    if (positions.empty()) return 1;
+    vector<string> names = {"P1", "P2"};
+    vector<uint8_t> buffers(positions.size() * MAX_SNAPSHOT_BYTES);
+    vector<size_t> sizes(positions.size());
+    size_t bytes = 0;
+
+    MonopolyDealGame restored(names, 0);
+    for (size_t i = 0; i < positions.size(); i++) {
+        uint8_t* data = &buffers[i * MAX_SNAPSHOT_BYTES];
+        sizes[i] = writeSnapshot(positions[i], data);
+        bytes += sizes[i];
+        if (!readSnapshot(restored, data, sizes[i]) || !restored.sameState(positions[i]) ||
+            restored.hash() != positions[i].hash()) {
+            cerr << "snapshot " << i << " did not restore the position\n";
+            return 1;
+        }
+        if (i % 10) continue;
+        MonopolyDealGame original = positions[i], copy = restored;
+        RandomPolicy a(i), b(i);
+        for (size_t seat = 0; seat < 2; seat++) {
+            original.setPolicy(seat, &a);
+            copy.setPolicy(seat, &b);
+        }
+        if (original.playGame(200) != copy.playGame(200) || !copy.sameState(original)) {
+            cerr << "snapshot " << i << " played on differently from its source\n";
+            return 1;
+        }
+    }
+
+    // Damage every byte in turn, and cut the snapshot short at every length
+    MonopolyDealGame before = restored;
+    vector<uint8_t> damaged(buffers.begin(), buffers.begin() + sizes[0]);
+    int accepted = 0;
+    for (size_t i = 0; i < damaged.size(); i++) {
+        damaged[i] ^= 0x5a;
+        accepted += readSnapshot(restored, damaged.data(), damaged.size());
+        damaged[i] ^= 0x5a;
+        accepted += readSnapshot(restored, damaged.data(), i);
+    }
+    if (accepted || !restored.sameState(before)) {
+        cerr << accepted << " damaged snapshots were accepted\n";
+        return 1;
+    }
+
+    const char* path = "monopoly_bench_snapshots.bin";
+    vector<MonopolyDealGame> batch(positions.begin(), positions.begin() + 64), loaded(64, MonopolyDealGame(names, 0));
+    bool batchOk = saveSnapshots(path, batch) && loadSnapshots(path, loaded);
+    for (size_t i = 0; i < batch.size() && batchOk; i++) batchOk = loaded[i].sameState(batch[i]);
+    remove(path);
+    if (!batchOk) {
+        cerr << "a batch of snapshots did not survive the file\n";
+        return 1;
+    }
+
+    uint8_t out[MAX_SNAPSHOT_BYTES];
+    size_t sink = 0;
+    const long iterations = 1000000;
+    Timing write = timeOps(iterations, [&](long i) { sink += writeSnapshot(positions[i % positions.size()], out); });
+    Timing read = timeOps(iterations, [&](long i) {
+        size_t p = size_t(i) % positions.size();
+        sink += readSnapshot(restored, &buffers[p * MAX_SNAPSHOT_BYTES], sizes[p]);
+    });
+
+    cout << "\nsnapshots of " << positions.size() << " positions, "
+         << fixed << setprecision(1) << double(bytes) / positions.size() << " bytes each on average\n";
+    cout << "  all restore identically and play on identically; " << damaged.size() * 2
+         << " damaged copies refused; a batch of " << batch.size() << " survives the file\n";
+    show("snapshot.write", write);
+    show("snapshot.read", read);
+    cout << "(checksum " << sink << ")\n";
+    if (write.allocs > 0 || read.allocs > 0) {
+        cerr << "snapshots allocated\n";
+        return 1;
+    }
+    return 0;
+}
+
+struct BatchOutcome {
+    int winner, turns, money0, money1;
+    bool operator!=(const BatchOutcome& o) const {
+        return winner != o.winner || turns != o.turns || money0 != o.money0 || money1 != o.money1;
+    }
+};
+
+// Two-player greedy games under Rules, played by the engine
+template <class Rules>
+static vector<BatchOutcome> engineOutcomes(const vector<uint64_t>& seeds, int maxTurns) {
+    vector<BatchOutcome> outcomes(seeds.size());
+    BasicGreedyPolicy<Rules> greedy;
+    for (size_t g = 0; g < seeds.size(); g++) {
+        BasicMonopolyDealGame<Rules> game({"P1", "P2"}, seeds[g]);
+        game.setPolicy(0, &greedy);
+        game.setPolicy(1, &greedy);
+        int winner = game.playGame(maxTurns);
+        outcomes[g] = {winner, game.getTurnCount(), game.getPlayers()[0].getMoney(), game.getPlayers()[1].getMoney()};
+    }
+    return outcomes;
+}
+
+// Whether every game of a finished batch ended as in the engine
+template <class Rules>
+static bool batchMatches(const BasicBatchSimulator<Rules>& batch, const vector<BatchOutcome>& expected, const char* what) {
+    for (size_t g = 0; g < expected.size(); g++) {
+        BatchOutcome got = {batch.getWinner(g), batch.getTurnCount(g), batch.getMoney(g, 0), batch.getMoney(g, 1)};
+        if (got != expected[g]) {
+            cerr << "batched game " << g << " (" << what << ") differs from the engine\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// The lockstep batch simulator against the engine playing the same greedy
+// bots on the same seeds. Every game must end identically, under the
+// standard rules and under a variant. Each side is timed as the best of a
+// few runs, dealing included; the speedup is reported, never checked, since
+// it depends on the machine and the build.
+static int benchBatch() {
+    const size_t games = 8192;
+    const int maxTurns = 1000;
+    const int runs = 3;
+    vector<uint64_t> seeds(games);
+    for (size_t g = 0; g < games; g++) seeds[g] = deriveSeed(21, g);
+
+    vector<BatchOutcome> expected;
+    double engineSeconds = numeric_limits<double>::infinity();
+    for (int run = 0; run < runs; run++) {
+        auto start = chrono::steady_clock::now();
+        expected = engineOutcomes<StandardRules>(seeds, maxTurns);
+        engineSeconds = min(engineSeconds, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+
+    cout << "\nbatched greedy games vs the engine, " << games << " games\n";
+    cout << fixed << setprecision(0);
+    cout << "  engine:           " << games / engineSeconds << " games/sec\n";
+    record("greedy game (engine)", engineSeconds * 1e9 / games, 0);
+
+    for (auto kernel : {BatchSimulator::Kernel::SCALAR, BatchSimulator::Kernel::AVX2}) {
+        BatchSimulator batch(seeds, 2, maxTurns, kernel);
+        bool avx2 = batch.usesAvx2();
+        if (kernel == BatchSimulator::Kernel::AVX2 && !avx2) {
+            cout << "  (no AVX2 on this CPU)\n";
+            continue;
+        }
+        const char* name = avx2 ? "avx2" : "scalar";
+
+        batch.run();
+        if (!batchMatches(batch, expected, name)) return 1;
+        double seconds = numeric_limits<double>::infinity();
+        for (int run = 0; run < runs; run++) {
+            auto start = chrono::steady_clock::now();
+            BatchSimulator timed(seeds, 2, maxTurns, kernel);
+            timed.run();
+            seconds = min(seconds, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+        }
+
+        const int refreshes = 2000;
+        double kernelNs = nsPerOp(refreshes, [&](long) { batch.refreshSets(); }) / games;
+        cout << "  batch, " << left << setw(10) << string(name) + ":" << right << games / seconds << " games/sec ("
+             << setprecision(2) << engineSeconds / seconds << "x the engine), set kernel " << kernelNs << " ns/game\n"
+             << setprecision(0);
+        record(string("greedy game (batch, ") + name + ")", seconds * 1e9 / games, 0);
+        record(string("set kernel per game (") + name + ")", kernelNs, 0);
+    }
+
+    // SpeedRules changes set sizes, plays, draws, the hand limit and the deck
+    vector<uint64_t> speedSeeds(seeds.begin(), seeds.begin() + 1024);
+    vector<BatchOutcome> speed = engineOutcomes<SpeedRules>(speedSeeds, maxTurns);
+    for (auto kernel : {BasicBatchSimulator<SpeedRules>::Kernel::SCALAR, BasicBatchSimulator<SpeedRules>::Kernel::AUTO}) {
+        BasicBatchSimulator<SpeedRules> batch(speedSeeds, 2, maxTurns, kernel);
+        batch.run();
+        if (!batchMatches(batch, speed, batch.usesAvx2() ? "speed rules, avx2" : "speed rules, scalar")) return 1;
+    }
+    cout << "  " << speedSeeds.size() << " games under the speed rules match too\n";
+    return 0;
+}
+
+// Terminal output of 4-player greedy games, written to a stream that drops it
+static int benchRender() {
+    const int games = 200;
+    struct NullBuffer : streambuf {
+        int overflow(int c) override { return c; }
+        streamsize xsputn(const char*, streamsize n) override { return n; }
+    } nullBuffer;
+    ostream sink(&nullBuffer);
+
+    cout << "\nterminal output, 4 greedy players, " << games << " games\n";
+    GreedyPolicy greedy;
+    for (int mode = 0; mode < 3; mode++) {
+        const char* name = mode == 0 ? "quiet" : mode == 1 ? "scroll" : "panel";
+        uint64_t bytes = 0;
+        long turns = 0;
+        double ns = 0;
+        for (int g = 0; g < games; g++) {
+            MonopolyDealGame game({"Alice", "Bob", "Carol", "Dave"}, deriveSeed(13, g));
+            for (int p = 0; p < 4; p++) game.setPolicy(p, &greedy);
+            TerminalRenderer renderer(mode == 1 ? TerminalRenderer::Mode::SCROLL : TerminalRenderer::Mode::PANEL, sink);
+            if (mode) game.setObserver(&renderer);
+            auto start = chrono::steady_clock::now();
+            game.playGame(1000);
+            ns += chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+            bytes += renderer.bytesWritten();
+            turns += game.getTurnCount();
+        }
+        cout << "  " << left << setw(8) << name << right << fixed << setprecision(0) << setw(10) << ns / turns << " ns/turn"
+             << setw(10) << double(bytes) / turns << " bytes/turn\n";
+        record(string("render turn (") + name + ")", ns / turns, 0);
+    }
+    return 0;
+}
+
+// Random games under one rule set: throughput, game length and a check that
+// every winner really holds the sets the rules ask for
+template <class Rules>
+static int benchRuleSet(const char* name, int players, int games) {
+    vector<string> names;
+    for (int p = 0; p < players; p++) names.push_back("P" + to_string(p + 1));
+    vector<BasicRandomPolicy<Rules>> policies;
+    for (int p = 0; p < players; p++) policies.emplace_back(0);
+
+    long turns = 0, won = 0;
+    auto start = chrono::steady_clock::now();
+    for (int g = 0; g < games; g++) {
+        BasicMonopolyDealGame<Rules> game(names, deriveSeed(15, g));
+        for (int p = 0; p < players; p++) {
+            policies[p].reseed(deriveSeed(16, uint64_t(g) * players + p));
+            game.setPolicy(p, &policies[p]);
+        }
+        int winner = game.playGame(1000);
+        turns += game.getTurnCount();
+        if (winner < 0) continue;
+        won++;
+        if (game.getPlayers()[winner].getCompleteSetCount() < Rules::SETS_TO_WIN) {
+            cerr << name << " game " << g << " was won without " << Rules::SETS_TO_WIN << " sets\n";
+            return 1;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "  " << left << setw(22) << string(name) + ", " + to_string(players) + " players" << right << fixed
+         << setprecision(0) << setw(9) << games / seconds << " games/sec" << setprecision(1) << setw(8)
+         << double(turns) / games << " turns/game" << setprecision(0) << setw(7) << seconds * 1e9 / turns << " ns/turn"
+         << setw(6) << 100.0 * won / games << "% won\n";
+    record(string("random game (") + name + ", " + to_string(players) + " players)", seconds * 1e9 / games, 0);
+    return 0;
+}
+
+// Each rule set from Rules.h is its own instantiation of the engine
+static int benchRules() {
+    const int games = 20000;
+    cout << "\nrule sets, random players, " << games << " games each\n";
+    return benchRuleSet<StandardRules>("standard", 2, games) || benchRuleSet<SpeedRules>("speed", 2, games) ||
+           benchRuleSet<StandardRules>("standard", 4, games) || benchRuleSet<BigTableRules>("big table", 6, games);
+}
+
+// monopoly_bench [--json FILE] [--metrics FILE] [section...]
+// Sections: sets, wilds, engine, deck, rules, batch, render, movegen, perft, mcts, endgame, snapshot
+// (all by default)
+int main(int argc, char* argv[]) {
+    string jsonPath, metricsPath;
+    vector<string> sections;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--json" && i + 1 < argc) jsonPath = argv[++i];
+        else if (arg == "--metrics" && i + 1 < argc) metricsPath = argv[++i];
+        else sections.push_back(arg);
+    }
+    auto wanted = [&](const string& name) {
+        return sections.empty() || find(sections.begin(), sections.end(), name) != sections.end();
+    };
+
+    if (wanted("sets") && benchPropertySets()) return 1;
+    if (wanted("wilds") && benchWilds()) return 1;
+    if (wanted("engine") && benchEngine()) return 1;
+    if (wanted("deck") && benchDeck()) return 1;
+    if (wanted("rules") && benchRules()) return 1;
+    if (wanted("batch") && benchBatch()) return 1;
+    if (wanted("render") && benchRender()) return 1;
+    if (wanted("movegen") && benchMoveGeneration()) return 1;
+    if (wanted("perft") && benchMakeUnmake()) return 1;
+    if (wanted("mcts") && benchMcts()) return 1;
+    if (wanted("endgame") && benchEndgame()) return 1;
+    if (wanted("snapshot") && benchSnapshot()) return 1;
+
+    if (!jsonPath.empty() && !writeJson(jsonPath)) {
+        cerr << "could not write " << jsonPath << "\n";
+        return 1;
+    }
+    if (!metricsPath.empty() && !metrics::writeJson(metricsPath)) {
+        cerr << "could not write " << metricsPath << "\n";
+        return 1;
+    }
+    return 0;
+}
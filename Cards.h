@@ -0,0 +1,334 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+
+// Card types
+enum class CardType : uint8_t { PROPERTY, MONEY, ACTION, RENT, WILD };
+
+// Property colors (simplified names)
+enum class PropertyColor : uint8_t { BROWN, BLUE, PINK, ORANGE, RED, YELLOW, GREEN, DARKBLUE, UTILITY, RAILROAD, NONE };
+
+// Action cards are told apart by kind instead of by comparing names
+enum class ActionKind : uint8_t { NONE, DEAL_BREAKER, SLY_DEAL, FORCED_DEAL, JUST_SAY_NO };
+
+// Property set requirements
+const std::map<PropertyColor, std::pair<int, std::string>> PROPERTY_SETS = {
+    {PropertyColor::BROWN, {2, "Brown (2)"}},
+    {PropertyColor::BLUE, {3, "Blue (3)"}},
+    {PropertyColor::PINK, {3, "Pink (3)"}},
+    {PropertyColor::ORANGE, {3, "Orange (3)"}},
+    {PropertyColor::RED, {3, "Red (3)"}},
+    {PropertyColor::YELLOW, {3, "Yellow (3)"}},
+    {PropertyColor::GREEN, {3, "Green (3)"}},
+    {PropertyColor::DARKBLUE, {2, "Dark Blue (2)"}},
+    {PropertyColor::UTILITY, {2, "Utility (2)"}},
+    {PropertyColor::RAILROAD, {4, "Railroad (4)"}}
+};
+
+constexpr int NUM_COLORS = 10;
+
+// Most seats at one table under the standard rules
+constexpr int MAX_PLAYERS = 4;
+
+// Most seats any rules variant may have (see Rules.h); sizes per-seat tables
+constexpr int MAX_SEATS = 6;
+
+// Cards needed for a complete set, indexed by PropertyColor
+constexpr std::array<uint8_t, NUM_COLORS> SET_SIZES = {2, 3, 3, 3, 3, 3, 3, 2, 2, 4};
+
+// Cards are passed around as an index into CARD_CATALOG
+using CardId = uint8_t;
+
+// Everything that is fixed about a card. Lives only in the catalog.
+struct CardInfo {
+    const char* name = "";
+    CardType type = CardType::MONEY;
+    uint8_t value = 0;
+    PropertyColor color = PropertyColor::NONE;
+    bool isWild = false;
+    PropertyColor wildColors[2] = {PropertyColor::NONE, PropertyColor::NONE};
+    ActionKind action = ActionKind::NONE;
+};
+
+constexpr int NUM_CARDS = 172;
+
+namespace detail {
+
+struct CatalogBuilder {
+    std::array<CardInfo, NUM_CARDS> cards{};
+    int size = 0;
+
+    constexpr void add(const CardInfo& card, int count) {
+        for (int i = 0; i < count; i++) cards[size++] = card;
+    }
+
+    constexpr void addProperty(const char* name, uint8_t value, PropertyColor color, int count) {
+        CardInfo card;
+        card.name = name;
+        card.type = CardType::PROPERTY;
+        card.value = value;
+        card.color = color;
+        add(card, count);
+    }
+
+    constexpr void addWild(const char* name, PropertyColor first, PropertyColor second, int count) {
+        CardInfo card;
+        card.name = name;
+        card.type = CardType::PROPERTY;
+        card.isWild = true;
+        card.wildColors[0] = first;
+        card.wildColors[1] = second;
+        add(card, count);
+    }
+
+    constexpr void addMoney(const char* name, uint8_t value, int count) {
+        CardInfo card;
+        card.name = name;
+        card.type = CardType::MONEY;
+        card.value = value;
+        add(card, count);
+    }
+
+    constexpr void addAction(const char* name, CardType type, uint8_t value, ActionKind action, int count) {
+        CardInfo card;
+        card.name = name;
+        card.type = type;
+        card.value = value;
+        card.action = action;
+        add(card, count);
+    }
+};
+
+// Same cards, in the same order, as the deck has always been built
+constexpr CatalogBuilder buildCatalog() {
+    CatalogBuilder deck;
+
+    // Property cards (82)
+    deck.addProperty("Mediterranean", 1, PropertyColor::BROWN, 2);
+    deck.addProperty("Baltic", 1, PropertyColor::BROWN, 2);
+    deck.addProperty("Oriental", 1, PropertyColor::BLUE, 3);
+    deck.addProperty("Vermont", 1, PropertyColor::BLUE, 3);
+    deck.addProperty("Connecticut", 1, PropertyColor::BLUE, 3);
+    deck.addProperty("St. Charles", 2, PropertyColor::PINK, 3);
+    deck.addProperty("States", 2, PropertyColor::PINK, 3);
+    deck.addProperty("Virginia", 2, PropertyColor::PINK, 3);
+    deck.addProperty("St. James", 3, PropertyColor::ORANGE, 3);
+    deck.addProperty("Tennessee", 3, PropertyColor::ORANGE, 3);
+    deck.addProperty("New York", 3, PropertyColor::ORANGE, 3);
+    deck.addProperty("Kentucky", 3, PropertyColor::RED, 3);
+    deck.addProperty("Indiana", 3, PropertyColor::RED, 3);
+    deck.addProperty("Illinois", 3, PropertyColor::RED, 3);
+    deck.addProperty("Atlantic", 4, PropertyColor::YELLOW, 3);
+    deck.addProperty("Ventnor", 4, PropertyColor::YELLOW, 3);
+    deck.addProperty("Marvin", 4, PropertyColor::YELLOW, 3);
+    deck.addProperty("Pacific", 4, PropertyColor::GREEN, 3);
+    deck.addProperty("N. Carolina", 4, PropertyColor::GREEN, 3);
+    deck.addProperty("Pennsylvania", 4, PropertyColor::GREEN, 3);
+    deck.addProperty("Park Place", 5, PropertyColor::DARKBLUE, 2);
+    deck.addProperty("Boardwalk", 5, PropertyColor::DARKBLUE, 2);
+    deck.addProperty("Electric Co.", 2, PropertyColor::UTILITY, 2);
+    deck.addProperty("Water Works", 2, PropertyColor::UTILITY, 2);
+    deck.addProperty("Reading RR", 1, PropertyColor::RAILROAD, 4);
+    deck.addProperty("Pennsylvania RR", 1, PropertyColor::RAILROAD, 4);
+    deck.addProperty("B. & O. RR", 1, PropertyColor::RAILROAD, 4);
+    deck.addProperty("Short Line", 1, PropertyColor::RAILROAD, 4);
+
+    // Wild cards (6)
+    deck.addWild("Wild (Blue/Green)", PropertyColor::DARKBLUE, PropertyColor::GREEN, 2);
+    deck.addWild("Wild (Red/Yellow)", PropertyColor::RED, PropertyColor::YELLOW, 2);
+    deck.addWild("Wild (Brown/Blue)", PropertyColor::BROWN, PropertyColor::BLUE, 2);
+
+    // Money cards (47)
+    deck.addMoney("$1", 1, 10);
+    deck.addMoney("$2", 2, 10);
+    deck.addMoney("$3", 3, 10);
+    deck.addMoney("$4", 4, 10);
+    deck.addMoney("$5", 5, 5);
+    deck.addMoney("$10", 10, 2);
+
+    // Action cards (37)
+    deck.addAction("Deal Breaker", CardType::ACTION, 0, ActionKind::DEAL_BREAKER, 5);
+    deck.addAction("Sly Deal", CardType::ACTION, 0, ActionKind::SLY_DEAL, 5);
+    deck.addAction("Forced Deal", CardType::ACTION, 0, ActionKind::FORCED_DEAL, 5);
+    deck.addAction("Just Say No", CardType::ACTION, 0, ActionKind::JUST_SAY_NO, 5);
+    deck.addAction("Rent (1 Color)", CardType::RENT, 3, ActionKind::NONE, 10);
+    deck.addAction("Rent (All Colors)", CardType::RENT, 1, ActionKind::NONE, 7);
+
+    return deck;
+}
+
+constexpr CatalogBuilder BUILT_CATALOG = buildCatalog();
+static_assert(BUILT_CATALOG.size == NUM_CARDS, "NUM_CARDS must match the deck built by buildCatalog");
+
+} // namespace detail
+
+constexpr std::array<CardInfo, NUM_CARDS> CARD_CATALOG = detail::BUILT_CATALOG.cards;
+
+constexpr const CardInfo& cardInfo(CardId id) { return CARD_CATALOG[id]; }
+
+// Cards the rules cannot tell apart (every Red property, every $3, both
+// kinds of rent) share a kind, so move generation offers each only once.
+constexpr bool sameRules(const CardInfo& a, const CardInfo& b) {
+    if (a.type != b.type || a.action != b.action || a.isWild != b.isWild) return false;
+    if (a.type == CardType::MONEY) return a.value == b.value;
+    if (a.type == CardType::PROPERTY) {
+        return a.color == b.color && a.wildColors[0] == b.wildColors[0] && a.wildColors[1] == b.wildColors[1];
+    }
+    return true;
+}
+
+namespace detail {
+
+struct KindTable {
+    std::array<uint8_t, NUM_CARDS> kinds{};
+    int count = 0;
+};
+
+constexpr KindTable buildKinds() {
+    KindTable table;
+    for (int id = 0; id < NUM_CARDS; id++) {
+        int first = 0;
+        while (!sameRules(CARD_CATALOG[first], CARD_CATALOG[id])) first++;
+        table.kinds[id] = first == id ? uint8_t(table.count++) : table.kinds[first];
+    }
+    return table;
+}
+
+constexpr KindTable KIND_TABLE = buildKinds();
+
+} // namespace detail
+
+constexpr int NUM_KINDS = detail::KIND_TABLE.count;
+static_assert(NUM_KINDS <= 64, "card kinds must fit a 64-bit mask");
+
+constexpr uint8_t cardKind(CardId id) { return detail::KIND_TABLE.kinds[id]; }
+
+// Fixed-capacity stack of card IDs, big enough to hold the whole deck, so
+// moving cards between hands and piles never allocates.
+class CardPile {
+private:
+    std::array<CardId, NUM_CARDS> cards;
+    uint8_t count;
+
+public:
+    CardPile() : count(0) {}
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    void clear() { count = 0; }
+
+    CardId operator[](size_t i) const { return cards[i]; }
+    CardId& operator[](size_t i) { return cards[i]; }
+    CardId back() const { return cards[count - 1]; }
+
+    void push_back(CardId id) { cards[count++] = id; }
+    void pop_back() { count--; }
+
+    // Keeps the order of the remaining cards, like vector::erase
+    void erase(size_t index) {
+        for (size_t i = index + 1; i < count; i++) cards[i - 1] = cards[i];
+        count--;
+    }
+
+    // Puts a card back at `index`, undoing erase
+    void insert(size_t index, CardId id) {
+        for (size_t i = count; i > index; i--) cards[i] = cards[i - 1];
+        cards[index] = id;
+        count++;
+    }
+
+    bool operator==(const CardPile& other) const {
+        if (count != other.count) return false;
+        for (size_t i = 0; i < count; i++) {
+            if (cards[i] != other.cards[i]) return false;
+        }
+        return true;
+    }
+    bool operator!=(const CardPile& other) const { return !(*this == other); }
+
+    CardId* begin() { return cards.data(); }
+    CardId* end() { return cards.data() + count; }
+    const CardId* begin() const { return cards.data(); }
+    const CardId* end() const { return cards.data() + count; }
+};
+
+// The colors a player chooses between (a wild's two sides, sets or
+// properties to steal), inline like CardPile so asking never allocates
+class ColorList {
+private:
+    std::array<PropertyColor, NUM_COLORS> colors;
+    uint8_t count;
+
+public:
+    ColorList() : count(0) {}
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    PropertyColor operator[](size_t i) const { return colors[i]; }
+    void push_back(PropertyColor color) { colors[count++] = color; }
+
+    const PropertyColor* begin() const { return colors.data(); }
+    const PropertyColor* end() const { return colors.data() + count; }
+};
+
+constexpr int countCards(bool (*match)(const CardInfo&)) {
+    int count = 0;
+    for (const auto& card : CARD_CATALOG) {
+        if (match(card)) count++;
+    }
+    return count;
+}
+
+constexpr int NUM_WILDS = countCards([](const CardInfo& card) { return card.isWild; });
+
+// Most real property cards of one color in the deck
+constexpr int maxColorCards() {
+    int most = 0;
+    for (int c = 0; c < NUM_COLORS; c++) {
+        int count = 0;
+        for (const auto& card : CARD_CATALOG) {
+            if (!card.isWild && card.type == CardType::PROPERTY && int(card.color) == c) count++;
+        }
+        most = count > most ? count : most;
+    }
+    return most;
+}
+
+constexpr int MAX_COLOR_CARDS = maxColorCards();
+
+constexpr int sumMoney() {
+    int total = 0;
+    for (const auto& card : CARD_CATALOG) {
+        if (card.type == CardType::MONEY) total += card.value;
+    }
+    return total;
+}
+
+// Money only enters the game from money cards, so no bank can exceed this
+constexpr int MAX_MONEY = sumMoney();
+
+namespace detail {
+
+constexpr std::array<int8_t, NUM_CARDS> buildWildOrdinals() {
+    std::array<int8_t, NUM_CARDS> ordinals{};
+    int next = 0;
+    for (int id = 0; id < NUM_CARDS; id++) ordinals[id] = CARD_CATALOG[id].isWild ? int8_t(next++) : int8_t(-1);
+    return ordinals;
+}
+
+constexpr std::array<int8_t, NUM_CARDS> WILD_ORDINALS = buildWildOrdinals();
+
+} // namespace detail
+
+// Whether a wild card may be played as this color
+constexpr bool wildAllows(CardId id, PropertyColor color) {
+    const CardInfo& card = CARD_CATALOG[id];
+    return card.isWild && color != PropertyColor::NONE && (color == card.wildColors[0] || color == card.wildColors[1]);
+}
+
+// Position of a wild among the deck's wilds (0 to NUM_WILDS-1), or -1
+constexpr int wildOrdinal(CardId id) { return detail::WILD_ORDINALS[id]; }
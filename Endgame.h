@@ -0,0 +1,374 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "MonopolyDeal.h"
+#include "Moves.h"
+#include "Rng.h"
+#include "TranspositionTable.h"
+#include "Zobrist.h"
+
+struct EndgameConfig {
+    // Wall-clock budget per solve; the first horizon always completes
+    double seconds = 0.1;
+    // Deepest horizon tried, in turns begun after the position
+    int maxHorizon = 16;
+    size_t memoMegabytes = 16;
+    // Off only to check the solver against plain expectimax
+    bool memo = true;
+    bool pruning = true;
+};
+
+struct EndgameResult {
+    Move best;
+    // For the player to move: 1 for a certain win, 0 for a certain loss, and
+    // games still undecided at the horizon count half. Only when `exact` is
+    // it the true win probability; otherwise it is a score for this horizon.
+    double score;
+    // Turns searched to completion; exact means the value holds at any
+    // horizon (every line was decided, or a win or loss was forced). 0 when
+    // nothing was searched: the position was not a two-player game.
+    int horizon;
+    bool exact;
+};
+
+namespace detail {
+
+// Keys by card kind and per-color counts rather than by card, so positions
+// that differ only in which copy of a card sits where share a memo entry
+struct EndgameKeys {
+    std::array<std::array<uint64_t, NUM_KINDS>, 2> hand;
+    std::array<uint64_t, NUM_KINDS> drawPile;
+    std::array<uint64_t, NUM_KINDS> discardPile;
+    std::array<std::array<std::array<uint64_t, MAX_COLOR_CARDS + 1>, NUM_COLORS>, 2> real;
+    std::array<std::array<std::array<uint64_t, NUM_WILDS + 1>, NUM_COLORS>, 2> wild;
+    std::array<uint64_t, 2> root;
+};
+
+constexpr EndgameKeys buildEndgameKeys() {
+    EndgameKeys keys{};
+    SplitMix64 stream(0xe1d6a3e5eedULL);
+    for (int p = 0; p < 2; p++) {
+        for (auto& key : keys.hand[p]) key = stream.next();
+        for (auto& counts : keys.real[p]) {
+            for (auto& key : counts) key = stream.next();
+        }
+        for (auto& counts : keys.wild[p]) {
+            for (auto& key : counts) key = stream.next();
+        }
+        keys.root[p] = stream.next();
+    }
+    for (auto& key : keys.drawPile) key = stream.next();
+    for (auto& key : keys.discardPile) key = stream.next();
+    return keys;
+}
+
+inline constexpr EndgameKeys ENDGAME_KEYS = detail::buildEndgameKeys();
+
+} // namespace detail
+
+// Expectimax for two-player endgames. The player to move maximizes their
+// chance of winning within the horizon (exactly their win probability once
+// no line is left undecided, see EndgameResult), the opponent minimizes it, and each
+// card drawn is a chance node over the kinds left in the pile, weighted by
+// how many of each remain. Both hands are taken as known: to solve from one
+// player's view, determinize the game first.
+//
+// Searches deepen one turn at a time until the budget runs out or a search
+// no longer reaches the horizon. Lines where neither player can still
+// complete SETS_TO_WIN sets before the horizon are cut off, decision nodes
+// use alpha-beta, chance nodes the Star1 bounds, and results go to a
+// bounded memo keyed by card kinds (see detail::EndgameKeys).
+class EndgameSolver {
+private:
+    static constexpr int MAX_PLY = 256;
+    // Memo depth for values that no horizon can change
+    static constexpr int SETTLED = 255;
+
+    EndgameConfig config;
+    TranspositionTable memo;
+    std::vector<MoveList> moves;
+    std::vector<UndoRecord> undos;
+    std::vector<std::array<CardId, MAX_MOVE_DRAWS>> scripts;
+
+    MonopolyDealGame game;
+    size_t root = 0;
+    int rootTurn = 0;
+    int horizon = 0;
+    int dealBreakers = 0;
+    bool aborted = false;
+    bool reachedHorizon = false;
+    std::chrono::steady_clock::time_point deadline;
+
+    uint64_t nodes = 0;
+    uint64_t cutoffs = 0;
+    uint64_t totalNodes = 0;
+    double totalSeconds = 0;
+
+    uint64_t stateKey() const {
+        const auto& keys = detail::ENDGAME_KEYS;
+        uint64_t key = keys.root[root] ^ ZOBRIST.current[game.getCurrentPlayer()] ^ ZOBRIST.phase[int(game.getPhase())] ^
+                       ZOBRIST.plays[game.getPlaysThisTurn()];
+        for (int p = 0; p < 2; p++) {
+            const Player& player = game.getPlayers()[p];
+            for (CardId card : player.getHand()) key += keys.hand[p][cardKind(card)];
+            const PropertyTableau& table = player.getProperties();
+            for (int c = 0; c < NUM_COLORS; c++) {
+                PropertyColor color = PropertyColor(c);
+                key ^= keys.real[p][c][table.count(color)] ^ keys.wild[p][c][table.total(color) - table.count(color)];
+                if (table.isListed(color)) key ^= ZOBRIST.listed[p][c];
+            }
+            key ^= moneyKey(p, player.getMoney());
+            if (player.hasJustSayNoCard()) key ^= ZOBRIST.justSayNo[p];
+        }
+        for (CardId card : game.getDrawPile()) key += keys.drawPile[cardKind(card)];
+        for (CardId card : game.getDiscardPile()) key += keys.discardPile[cardKind(card)];
+        return key;
+    }
+
+    // Whether `seat` could still hold SETS_TO_WIN sets before the horizon:
+    // each play adds at most one card to a set, or one whole set with a Deal
+    // Breaker, and there are only so many plays left
+    bool canStillWin(size_t seat) const {
+        const Player& player = game.getPlayers()[seat];
+        int futureTurns = horizon - (game.getTurnCount() - rootTurn) - 1;
+        int plays = seat == game.getCurrentPlayer()
+                        ? (game.getPhase() == GamePhase::PLAY ? StandardRules::PLAYS_PER_TURN - game.getPlaysThisTurn() : 0) +
+                              futureTurns / 2 * StandardRules::PLAYS_PER_TURN
+                        : (futureTurns + 1) / 2 * StandardRules::PLAYS_PER_TURN;
+        int sets = player.getCompleteSetCount();
+        int stolen = std::min(plays, dealBreakers);
+        sets += stolen;
+        plays -= stolen;
+
+        std::array<int, NUM_COLORS> costs;
+        int incomplete = 0;
+        const PropertyTableau& table = player.getProperties();
+        for (int c = 0; c < NUM_COLORS; c++) {
+            if (!table.isComplete(PropertyColor(c))) costs[incomplete++] = SET_SIZES[c] - int(table.total(PropertyColor(c)));
+        }
+        std::sort(costs.begin(), costs.begin() + incomplete);
+        for (int i = 0; i < incomplete && costs[i] <= plays; i++) {
+            plays -= costs[i];
+            sets++;
+        }
+        return sets >= StandardRules::SETS_TO_WIN;
+    }
+
+    // A memo entry's move names the card kind in place of the hand slot,
+    // which differs between equivalent positions
+    Move kindMove(const Move& move) const {
+        Move stored = move;
+        if (move.type != MoveType::END_TURN) stored.handIndex = cardKind(game.getPlayers()[game.getCurrentPlayer()].getHand()[move.handIndex]);
+        return stored;
+    }
+
+    // A win found inside (alpha, beta) is exact even as a lower bound, since
+    // nothing lies above 1, and so is a loss as an upper bound
+    static bool settled(double value, double alpha, double beta) {
+        return (value >= 1 && value > alpha) || (value <= 0 && value < beta);
+    }
+
+    double value(int ply, double alpha, double beta) {
+        nodes++;
+        if (!config.pruning) {
+            alpha = -1;
+            beta = 2;
+        }
+        if (game.isOver()) return game.getWinner() == int(root) ? 1.0 : 0.0;
+        int remaining = horizon - (game.getTurnCount() - rootTurn);
+        if (remaining <= 0 || ply >= MAX_PLY) {
+            reachedHorizon = true;
+            return 0.5;
+        }
+        if (horizon > 1 && (nodes & 1023) == 0 && std::chrono::steady_clock::now() >= deadline) aborted = true;
+        if (aborted) return 0.5;
+
+        double low = 0, high = 1;
+        if (config.pruning) {
+            if (!canStillWin(1 - root)) low = 0.5;
+            if (!canStillWin(root)) high = 0.5;
+            if (low >= high || high <= alpha || low >= beta) {
+                cutoffs++;
+                reachedHorizon = true;
+                return high <= alpha ? high : low;
+            }
+        }
+
+        uint64_t key = 0;
+        Move hint = Move::endTurn();
+        bool hinted = false;
+        if (config.memo) {
+            key = stateKey();
+            if (const TTEntry* entry = memo.probe(key)) {
+                bool usable = entry->depth == SETTLED || entry->depth == remaining;
+                if (usable && (entry->bound == TTBound::EXACT || (entry->bound == TTBound::LOWER && entry->value >= beta) ||
+                               (entry->bound == TTBound::UPPER && entry->value <= alpha))) {
+                    if (entry->depth != SETTLED) reachedHorizon = true;
+                    return entry->value;
+                }
+                hint = entry->best;
+                hinted = true;
+            }
+        }
+
+        MoveList& list = moves[ply];
+        game.generateMoves(list);
+        int order[MAX_MOVES];
+        int count = list.size(), first = 0;
+        for (int i = 0; i < count; i++) {
+            order[i] = i;
+            if (hinted && kindMove(list[i]) == hint) std::swap(order[first++], order[i]);
+        }
+
+        bool maximize = game.getCurrentPlayer() == root;
+        bool outerReached = reachedHorizon;
+        reachedHorizon = false;
+        double best = maximize ? -1 : 2, a = alpha, b = beta;
+        Move bestMove = list[0];
+        for (int k = 0; k < count; k++) {
+            const Move& move = list[order[k]];
+            double v = expand(ply, move, 0, a, b);
+            if (aborted) return 0.5;
+            if (maximize ? v > best : v < best) {
+                best = v;
+                bestMove = move;
+            }
+            if (maximize) a = std::max(a, best);
+            else b = std::min(b, best);
+            if (a >= b) {
+                cutoffs++;
+                break;
+            }
+        }
+
+        // A certain win or loss stands at any horizon, whatever the lines
+        // that were cut short would have come to
+        bool dependsOnHorizon = reachedHorizon && !settled(best, alpha, beta);
+        reachedHorizon = outerReached || dependsOnHorizon;
+        if (config.memo) {
+            TTBound bound = best <= alpha ? TTBound::UPPER : best >= beta ? TTBound::LOWER : TTBound::EXACT;
+            memo.store(key, float(best), dependsOnHorizon ? std::min(remaining, SETTLED - 1) : SETTLED, bound, kindMove(bestMove));
+        }
+        return best;
+    }
+
+    // The value of playing `move` with the first `drawn` cards of the turns
+    // it begins already fixed. When the move needs another card the draw is
+    // a chance node: each kind left in the pile is tried in turn, and the
+    // loop stops once the rest of the pile cannot bring the average back
+    // inside (alpha, beta).
+    double expand(int ply, const Move& move, int drawn, double alpha, double beta) {
+        DrawScript script;
+        script.cards = scripts[ply].data();
+        script.count = uint8_t(drawn);
+        UndoRecord& undo = undos[ply];
+        game.applyMove(move, undo, script);
+        // The cards drawn cannot change a finished game, nor one past the horizon
+        if (!script.overrun || game.isOver() || game.getTurnCount() - rootTurn >= horizon) {
+            double v = value(ply + 1, alpha, beta);
+            game.undoMove(undo);
+            return v;
+        }
+        game.undoMove(undo);
+
+        const CardPile& pile = script.pile;
+        int copies[NUM_KINDS] = {};
+        CardId representative[NUM_KINDS];
+        for (CardId card : pile) {
+            if (!copies[cardKind(card)]++) representative[cardKind(card)] = card;
+        }
+
+        double sum = 0, left = 1;
+        for (int kind = 0; kind < NUM_KINDS; kind++) {
+            if (!copies[kind]) continue;
+            double p = double(copies[kind]) / pile.size();
+            left -= p;
+            scripts[ply][drawn] = representative[kind];
+            double v = expand(ply, move, drawn + 1, (alpha - sum - left) / p, (beta - sum) / p);
+            if (aborted) return 0.5;
+            sum += p * v;
+            if (config.pruning && left > 1e-12) {
+                if (sum + left <= alpha) {
+                    cutoffs++;
+                    return sum + left;
+                }
+                if (sum >= beta) {
+                    cutoffs++;
+                    return sum;
+                }
+            }
+        }
+        return sum;
+    }
+
+public:
+    explicit EndgameSolver(const EndgameConfig& config = EndgameConfig())
+        : config(config), memo(config.memoMegabytes), moves(MAX_PLY + 1), undos(MAX_PLY + 1), scripts(MAX_PLY + 1),
+          game({"P1", "P2"}, 0) {}
+
+    // Best move for the player to move in a two-player game. Any other
+    // table is refused unsearched: an end-turn move scored 0.5 at horizon 0.
+    EndgameResult solve(const MonopolyDealGame& position) {
+        // The keys, the opponent (1 - root) and the minimizing seat all
+        // assume two players
+        if (position.getPlayers().size() != 2) return {Move::endTurn(), 0.5, 0, false};
+        auto start = std::chrono::steady_clock::now();
+        deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                               std::chrono::duration<double>(config.seconds));
+        game = position;
+        game.setObserver(nullptr);
+        game.setMaxTurns(0);
+        root = game.getCurrentPlayer();
+        rootTurn = game.getTurnCount();
+        dealBreakers = 0;
+        auto countDealBreakers = [&](const CardPile& cards) {
+            for (CardId card : cards) dealBreakers += cardInfo(card).action == ActionKind::DEAL_BREAKER;
+        };
+        countDealBreakers(game.getDrawPile());
+        countDealBreakers(game.getDiscardPile());
+        for (const Player& player : game.getPlayers()) countDealBreakers(player.getHand());
+        memo.newSearch();
+        nodes = 0;
+
+        MoveList& rootMoves = moves[0];
+        EndgameResult result{Move::endTurn(), 0.5, 0, false};
+        for (horizon = 1; horizon <= config.maxHorizon; horizon++) {
+            aborted = false;
+            reachedHorizon = false;
+            // The last horizon's best move goes first. Later moves only need
+            // to show they cannot beat it.
+            game.generateMoves(rootMoves);
+            int first = 0;
+            for (int i = 0; i < rootMoves.size(); i++) {
+                if (rootMoves[i] == result.best) first = i;
+            }
+            double best = -1;
+            Move bestMove = rootMoves[first];
+            for (int k = 0; k < rootMoves.size() && !aborted; k++) {
+                const Move& move = rootMoves[k == 0 ? first : k == first ? 0 : k];
+                double v = expand(0, move, 0, config.pruning ? best : -1.0, 2.0);
+                if (!aborted && v > best) {
+                    best = v;
+                    bestMove = move;
+                }
+            }
+            if (aborted) break;
+            result = {bestMove, best, horizon, !reachedHorizon || settled(best, -1, 2)};
+            if (result.exact) break;
+        }
+
+        totalNodes += nodes;
+        totalSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+    uint64_t getNodes() const { return totalNodes; }
+    uint64_t getCutoffs() const { return cutoffs; }
+    double getSeconds() const { return totalSeconds; }
+    double statesPerSecond() const { return totalSeconds > 0 ? totalNodes / totalSeconds : 0; }
+    const TranspositionTable& getMemo() const { return memo; }
+};
@@ -0,0 +1,385 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "MonopolyDeal.h"
+
+// Binary game log. A file is the 4-byte magic "MDL1" followed by one record
+// per game:
+//
+//   varint  body length in bytes (so a reader can skip a game unparsed)
+//   varint  seed
+//   varint  player count
+//   varint  turn limit (0 = none)
+//   per player: varint hand size, then one byte per dealt card
+//   events, each a varint whose low 2 bits say what it is:
+//     0  play:    (handIndex * 11 + color) * 11 + take, colors as PropertyColor
+//     1  draw:    card id
+//     2  discard: hand index
+//     3  control: 0 = end turn, 1 = game over, followed by
+//                 varint winner + 1, varint turn count, 8-byte position hash
+//
+// The seed alone fixes the deal and every reshuffle, so the deal and draws
+// are there for tools that read a log without the engine and as a check
+// when replaying. A two-player game takes about 250 bytes.
+namespace gamelog {
+
+constexpr char MAGIC[4] = {'M', 'D', 'L', '1'};
+
+enum Event : uint8_t { PLAY = 0, DRAW = 1, DISCARD = 2, CONTROL = 3 };
+enum Control : uint8_t { END_TURN = 0, GAME_OVER = 1 };
+
+inline void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(uint8_t(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(uint8_t(value));
+}
+
+// Reads one varint at `pos`; false if it runs past `end` or is too long
+inline bool getVarint(const uint8_t*& pos, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < end; shift += 7) {
+        uint8_t byte = *pos++;
+        value |= uint64_t(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+inline uint64_t packMove(const Move& move) {
+    switch (move.type) {
+        case MoveType::PLAY:
+            return ((uint64_t(move.handIndex) * 11 + uint64_t(move.color)) * 11 + uint64_t(move.take)) << 2 | PLAY;
+        case MoveType::DISCARD: return uint64_t(move.handIndex) << 2 | DISCARD;
+        default: return uint64_t(END_TURN) << 2 | CONTROL;
+    }
+}
+
+}  // namespace gamelog
+
+// Appends bytes to a log file from any number of threads. Callers fill one
+// buffer while a background thread writes the other, so the game loop only
+// waits if the disk falls a whole buffer behind.
+class GameLogWriter {
+private:
+    int fd = -1;
+    size_t capacity;
+    std::vector<uint8_t> filling;
+    std::vector<uint8_t> flushing;
+    bool flushPending = false;
+    bool stopping = false;
+    bool failed = false;
+    uint64_t written = 0;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::thread flusher;
+
+    void flushLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            changed.wait(lock, [&] { return flushPending || stopping; });
+            if (!flushPending) return;
+            lock.unlock();
+            bool ok = writeAll(flushing.data(), flushing.size());
+            lock.lock();
+            failed |= !ok;
+            written += flushing.size();
+            flushing.clear();
+            flushPending = false;
+            changed.notify_all();
+        }
+    }
+
+    bool writeAll(const uint8_t* data, size_t size) {
+        while (size > 0) {
+            ssize_t n = ::write(fd, data, size);
+            if (n <= 0) return false;
+            data += n;
+            size -= size_t(n);
+        }
+        return true;
+    }
+
+    // Hands the filled buffer to the flusher. Caller holds the lock.
+    void swapBuffers(std::unique_lock<std::mutex>& lock) {
+        changed.wait(lock, [&] { return !flushPending; });
+        filling.swap(flushing);
+        flushPending = true;
+        changed.notify_all();
+    }
+
+public:
+    explicit GameLogWriter(size_t bufferBytes = 4 << 20) : capacity(bufferBytes) {
+        filling.reserve(capacity);
+        flushing.reserve(capacity);
+    }
+    ~GameLogWriter() { close(); }
+
+    GameLogWriter(const GameLogWriter&) = delete;
+    GameLogWriter& operator=(const GameLogWriter&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        failed = false;
+        written = 0;
+        stopping = false;
+        filling.insert(filling.end(), gamelog::MAGIC, gamelog::MAGIC + 4);
+        flusher = std::thread(&GameLogWriter::flushLoop, this);
+        return true;
+    }
+
+    // Appends one whole record; records from different threads never interleave
+    void append(const uint8_t* data, size_t size) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (filling.size() + size > capacity && !filling.empty()) swapBuffers(lock);
+        filling.insert(filling.end(), data, data + size);
+    }
+
+    // Writes out everything appended so far and closes the file.
+    // Returns false if any write failed.
+    bool close() {
+        if (fd < 0) return !failed;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!filling.empty()) swapBuffers(lock);
+            changed.wait(lock, [&] { return !flushPending; });
+            stopping = true;
+            changed.notify_all();
+        }
+        flusher.join();
+        failed |= ::close(fd) != 0;
+        fd = -1;
+        return !failed;
+    }
+
+    uint64_t bytesWritten() const { return written; }
+};
+
+// Observer that encodes one game at a time and hands each finished record
+// to a GameLogWriter. Use one per thread.
+class GameLogRecorder : public GameObserver {
+private:
+    GameLogWriter& writer;
+    std::vector<uint8_t> body;
+    std::vector<uint8_t> record;
+
+public:
+    explicit GameLogRecorder(GameLogWriter& writer) : writer(writer) {}
+
+    void onGameStart(const MonopolyDealGame& game) override {
+        body.clear();
+        gamelog::putVarint(body, game.getSeed());
+        gamelog::putVarint(body, game.getPlayers().size());
+        gamelog::putVarint(body, uint64_t(game.getMaxTurns()));
+        for (const auto& player : game.getPlayers()) {
+            gamelog::putVarint(body, player.getHand().size());
+            for (CardId card : player.getHand()) body.push_back(card);
+        }
+    }
+    void onDraw(const Player&, CardId card) override {
+        gamelog::putVarint(body, uint64_t(card) << 2 | gamelog::DRAW);
+    }
+    void onMove(const Player&, const Move& move) override {
+        gamelog::putVarint(body, gamelog::packMove(move));
+    }
+
+    // Seals the game's record once it is over and queues it for writing
+    void finish(const MonopolyDealGame& game) {
+        gamelog::putVarint(body, uint64_t(gamelog::GAME_OVER) << 2 | gamelog::CONTROL);
+        gamelog::putVarint(body, uint64_t(game.getWinner() + 1));
+        gamelog::putVarint(body, uint64_t(game.getTurnCount()));
+        uint64_t hash = game.hash();
+        for (int i = 0; i < 8; i++) body.push_back(uint8_t(hash >> (8 * i)));
+
+        record.clear();
+        gamelog::putVarint(record, body.size());
+        record.insert(record.end(), body.begin(), body.end());
+        writer.append(record.data(), record.size());
+    }
+};
+
+// One game's record inside a mapped log
+struct GameLogRecord {
+    const uint8_t* data;
+    size_t size;
+};
+
+// Read-only memory map of a log file. Pages are read in as the cursor
+// reaches them, so files far larger than memory can be scanned.
+class MappedGameLog {
+private:
+    const uint8_t* data = nullptr;
+    size_t length = 0;
+    size_t offset = 0;
+    bool corrupt = false;
+
+public:
+    MappedGameLog() = default;
+    ~MappedGameLog() { close(); }
+
+    MappedGameLog(const MappedGameLog&) = delete;
+    MappedGameLog& operator=(const MappedGameLog&) = delete;
+
+    // False if the file is missing, cannot be mapped or is not a game log
+    bool open(const std::string& path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < 4) {
+            ::close(fd);
+            return false;
+        }
+        void* mapped = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) return false;
+        madvise(mapped, size_t(info.st_size), MADV_SEQUENTIAL);
+        data = static_cast<const uint8_t*>(mapped);
+        length = size_t(info.st_size);
+        if (memcmp(data, gamelog::MAGIC, 4) != 0) {
+            close();
+            return false;
+        }
+        offset = 4;
+        return true;
+    }
+
+    void close() {
+        if (data) munmap(const_cast<uint8_t*>(data), length);
+        data = nullptr;
+        length = offset = 0;
+        corrupt = false;
+    }
+
+    // Steps to the next game. False at the end of the file or at a record
+    // that does not fit in it (see isCorrupt).
+    bool next(GameLogRecord& record) {
+        if (offset >= length) return false;
+        const uint8_t* pos = data + offset;
+        const uint8_t* end = data + length;
+        uint64_t size;
+        if (!gamelog::getVarint(pos, end, size) || size > uint64_t(end - pos)) {
+            corrupt = true;
+            return false;
+        }
+        record = {pos, size_t(size)};
+        offset = size_t(pos - data) + size_t(size);
+        return true;
+    }
+
+    bool isCorrupt() const { return corrupt; }
+    size_t size() const { return length; }
+};
+
+// What replaying a record found
+struct ReplayResult {
+    bool ok = false;
+    std::string error;
+    int winner = -1;
+    int turns = 0;
+    uint64_t events = 0;
+};
+
+// Replays one record through the engine: the deal, every move and every draw
+// must come out as logged, and the game must end as logged
+inline ReplayResult replayGame(const GameLogRecord& record) {
+    // Checks each draw the engine makes against the next one in the log
+    struct DrawCheck : GameObserver {
+        const uint8_t* pos;
+        const uint8_t* end;
+        bool mismatch = false;
+        void onDraw(const Player&, CardId card) override {
+            uint64_t value;
+            if (!gamelog::getVarint(pos, end, value) || value != (uint64_t(card) << 2 | gamelog::DRAW)) mismatch = true;
+        }
+    };
+
+    ReplayResult result;
+    const uint8_t* pos = record.data;
+    const uint8_t* end = record.data + record.size;
+    uint64_t seed, players, maxTurns;
+    if (!gamelog::getVarint(pos, end, seed) || !gamelog::getVarint(pos, end, players) ||
+        !gamelog::getVarint(pos, end, maxTurns) || players < 2 || players > MAX_PLAYERS) {
+        result.error = "bad header";
+        return result;
+    }
+
+    std::vector<std::string> names;
+    for (uint64_t i = 0; i < players; i++) names.push_back("P" + std::to_string(i + 1));
+    MonopolyDealGame game(names, seed);
+    for (const auto& player : game.getPlayers()) {
+        uint64_t count;
+        if (!gamelog::getVarint(pos, end, count) || count != player.getHand().size() ||
+            uint64_t(end - pos) < count || memcmp(pos, player.getHand().begin(), count) != 0) {
+            result.error = "initial deal differs";
+            return result;
+        }
+        pos += count;
+    }
+
+    DrawCheck draws;
+    draws.end = end;
+    draws.pos = pos;
+    game.setObserver(&draws);
+    game.setMaxTurns(int(maxTurns));
+    game.start();
+
+    while (true) {
+        uint64_t value;
+        if (draws.mismatch || !gamelog::getVarint(draws.pos, end, value)) {
+            result.error = draws.mismatch ? "draw differs" : "log ends mid-game";
+            return result;
+        }
+        result.events++;
+        uint64_t payload = value >> 2;
+        Move move;
+        switch (value & 3) {
+            case gamelog::PLAY:
+                move = Move::play(size_t(payload / 121), PropertyColor(payload / 11 % 11), PropertyColor(payload % 11));
+                break;
+            case gamelog::DISCARD: move = Move::discard(size_t(payload)); break;
+            case gamelog::DRAW:
+                result.error = "draw the engine did not make";
+                return result;
+            default:
+                if (payload == gamelog::END_TURN) {
+                    move = Move::endTurn();
+                    break;
+                }
+                uint64_t winner, turns;
+                if (payload != gamelog::GAME_OVER || !gamelog::getVarint(draws.pos, end, winner) ||
+                    !gamelog::getVarint(draws.pos, end, turns) || end - draws.pos != 8) {
+                    result.error = "bad game-over record";
+                    return result;
+                }
+                uint64_t hash = 0;
+                for (int i = 0; i < 8; i++) hash |= uint64_t(draws.pos[i]) << (8 * i);
+                result.winner = game.getWinner();
+                result.turns = game.getTurnCount();
+                if (!game.isOver() || int64_t(winner) - 1 != result.winner || turns != uint64_t(result.turns) ||
+                    hash != game.hash()) {
+                    result.error = "final state differs";
+                    return result;
+                }
+                result.ok = true;
+                return result;
+        }
+        if (game.isOver() || !game.applyMove(move)) {
+            result.error = "illegal move";
+            return result;
+        }
+    }
+}
@@ -0,0 +1,152 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "Server.h"
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+// One bot client: picks a random legal move from every MOVES line
+struct Client {
+    int fd;
+    string input;
+    Xoshiro256 rng;
+    uint64_t nextSeed;
+    int gamesLeft;
+    Clock::time_point sentAt;
+    bool done = false;
+};
+
+static void usage(const char* program) {
+    cerr << "usage: " << program << " [--connect tcp:[HOST:]PORT | unix:PATH] [--sessions N] [--games G]"
+         << " [--players P] [--seed S]\n";
+}
+
+static bool sendLine(Client& client, const string& line) {
+    client.sentAt = Clock::now();
+    // Requests are tiny, so a write only ever comes up short if the server is gone
+    return write(client.fd, line.data(), line.size()) == ssize_t(line.size());
+}
+
+// Drives many sessions at once against monopoly_server and reports how long
+// the server takes to answer each move, bots' turns included
+int main(int argc, char** argv) {
+    string endpoint = "tcp:127.0.0.1:7777";
+    int sessions = 256, games = 20, players = 2;
+    uint64_t seed = 1;
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) { usage(argv[0]); return 1; }
+        const char* value = argv[++i];
+        if (!strcmp(argv[i - 1], "--connect")) endpoint = value;
+        else if (!strcmp(argv[i - 1], "--sessions")) sessions = atoi(value);
+        else if (!strcmp(argv[i - 1], "--games")) games = atoi(value);
+        else if (!strcmp(argv[i - 1], "--players")) players = atoi(value);
+        else if (!strcmp(argv[i - 1], "--seed")) seed = strtoull(value, nullptr, 10);
+        else { usage(argv[0]); return 1; }
+    }
+    if (sessions < 1 || games < 1 || players < 2 || players > MAX_PLAYERS) {
+        usage(argv[0]);
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    int epoll = epoll_create1(0);
+    vector<Client> clients;
+    clients.reserve(sessions);
+    for (int s = 0; s < sessions; s++) {
+        int fd = openEndpoint(endpoint, false);
+        if (fd < 0) {
+            cerr << "cannot connect to " << endpoint << ": " << strerror(errno) << "\n";
+            return 1;
+        }
+        setNonBlocking(fd);
+        clients.push_back({fd, "", Xoshiro256(deriveSeed(seed, s)), deriveSeed(seed, uint64_t(s) << 32), games, {}});
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u32 = uint32_t(s);
+        epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    auto start = Clock::now();
+    const string playerArg = " " + to_string(players) + "\n";
+    for (auto& client : clients) sendLine(client, "NEW " + to_string(client.nextSeed++) + playerArg);
+
+    vector<double> latencies;
+    uint64_t finished = 0, wins = 0, errors = 0;
+    int active = sessions;
+    epoll_event events[256];
+    while (active > 0) {
+        int ready = epoll_wait(epoll, events, 256, 5000);
+        if (ready == 0) {
+            cerr << "server stopped answering\n";
+            return 1;
+        }
+        for (int i = 0; i < ready; i++) {
+            Client& client = clients[events[i].data.u32];
+            char buffer[4096];
+            ssize_t n;
+            while ((n = read(client.fd, buffer, sizeof(buffer))) > 0) client.input.append(buffer, size_t(n));
+            if (n == 0) {
+                cerr << "server closed a session\n";
+                return 1;
+            }
+
+            size_t begin = 0;
+            for (size_t end; !client.done && (end = client.input.find('\n', begin)) != string::npos; begin = end + 1) {
+                const char* line = client.input.c_str() + begin;
+                size_t length = end - begin;
+                if (!strncmp(line, "STATE", 5)) continue;
+                latencies.push_back(chrono::duration<double, micro>(Clock::now() - client.sentAt).count());
+
+                if (!strncmp(line, "MOVES ", 6)) {
+                    // Pick the k-th space-separated move
+                    int count = int(std::count(line + 5, line + length, ' '));
+                    int pick = int(client.rng.below(uint32_t(count)));
+                    const char* move = line + 6;
+                    while (pick--) move = strchr(move, ' ') + 1;
+                    const char* moveEnd = move;
+                    while (moveEnd < line + length && *moveEnd != ' ') moveEnd++;
+                    sendLine(client, "MOVE " + string(move, moveEnd) + "\n");
+                }
+                else if (!strncmp(line, "OVER ", 5)) {
+                    finished++;
+                    wins += atoi(line + 5) == 0;
+                    if (--client.gamesLeft > 0) sendLine(client, "NEW " + to_string(client.nextSeed++) + playerArg);
+                    else client.done = true;
+                }
+                else {
+                    cerr << "server said: " << string(line, length) << "\n";
+                    errors++;
+                    client.done = true;
+                }
+            }
+            client.input.erase(0, begin);
+            if (client.done && client.fd >= 0) {
+                epoll_ctl(epoll, EPOLL_CTL_DEL, client.fd, nullptr);
+                sendLine(client, "QUIT\n");
+                close(client.fd);
+                client.fd = -1;
+                active--;
+            }
+        }
+    }
+    double seconds = chrono::duration<double>(Clock::now() - start).count();
+    close(epoll);
+
+    sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) { return latencies[min(latencies.size() - 1, size_t(p * latencies.size()))]; };
+    cout << "sessions:     " << sessions << "\n";
+    cout << "games:        " << finished << " (" << wins << " won by the client seat)\n";
+    cout << "moves:        " << latencies.size() << "\n";
+    cout << "seconds:      " << seconds << "\n";
+    cout << "moves/sec:    " << latencies.size() / seconds << "\n";
+    cout << "latency p50:  " << percentile(0.50) << " us\n";
+    cout << "latency p99:  " << percentile(0.99) << " us\n";
+    cout << "latency max:  " << latencies.back() << " us\n";
+    cout << "errors:       " << errors << "\n";
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <vector>
+#include "MonopolyDeal.h"
+#include "Moves.h"
+#include "Policies.h"
+#include "Rng.h"
+
+struct MctsConfig {
+    // Playouts per decision, summed over all threads
+    uint64_t playouts = 1000;
+    // Wall-clock budget per decision; when set it replaces the playout count
+    double seconds = 0;
+    unsigned threads = 1;   // 0 = one per core
+    double exploration = 0.7;
+    // Turns a playout may run past the decision before it counts as a draw
+    int playoutTurns = 100;
+};
+
+// A move in the search tree. Moves are keyed by card kind rather than hand
+// position, so the same node is reached whatever the sampled hand looks like.
+struct MctsNode {
+    uint32_t key;
+    uint8_t player;
+    uint32_t firstChild;
+    uint32_t nextSibling;
+    uint32_t visits;
+    // How many times the move was legal when its parent was visited
+    uint32_t availability;
+    float reward;
+};
+
+// Arena for one tree. reset() keeps the memory, so after the first few
+// decisions a search allocates nothing.
+class NodePool {
+private:
+    std::vector<MctsNode> nodes;
+    uint32_t used = 0;
+
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    void reset() { used = 0; }
+    uint32_t size() const { return used; }
+
+    uint32_t allocate() {
+        if (used == nodes.size()) nodes.resize(std::max<size_t>(1024, nodes.size() * 2));
+        nodes[used] = MctsNode{0, 0, NONE, NONE, 0, 0, 0.0f};
+        return used++;
+    }
+
+    MctsNode& operator[](uint32_t i) { return nodes[i]; }
+    const MctsNode& operator[](uint32_t i) const { return nodes[i]; }
+};
+
+// Identifies a move across determinizations: what it does, not where the
+// card sits in the hand
+inline uint32_t moveKey(const MonopolyDealGame& game, const Move& move) {
+    uint32_t kind = 0xFF;
+    if (move.type != MoveType::END_TURN) kind = cardKind(game.getPlayers()[game.getCurrentPlayer()].getHand()[move.handIndex]);
+    return uint32_t(move.type) << 24 | kind << 16 | uint32_t(move.color) << 8 | uint32_t(move.take);
+}
+
+// Single-observer information set MCTS. Every playout starts from a fresh
+// determinization of what the player to move cannot see, and descends one
+// shared tree whose children are picked by UCB over their availability.
+// With several threads each grows its own tree (root parallelism) and the
+// root visit counts are summed at the end.
+class MctsSearch {
+private:
+    struct Worker {
+        NodePool pool;
+        std::optional<MonopolyDealGame> scratch;
+        Xoshiro256 rng;
+        MoveList moves;
+        uint32_t legal[MAX_MOVES];
+        std::vector<uint32_t> path;
+        uint64_t playouts = 0;
+    };
+
+    MctsConfig config;
+    std::vector<Worker> workers;
+    uint64_t seed;
+    uint64_t searches = 0;
+    uint64_t totalPlayouts = 0;
+    double totalSeconds = 0;
+
+    void iterate(Worker& w, const MonopolyDealGame& root) {
+        size_t viewer = root.getCurrentPlayer();
+        if (w.scratch) *w.scratch = root;
+        else w.scratch.emplace(root);
+        MonopolyDealGame& game = *w.scratch;
+        game.setObserver(nullptr);
+        game.determinize(viewer, w.rng);
+
+        NodePool& pool = w.pool;
+        w.path.clear();
+        uint32_t node = 0;
+        w.path.push_back(node);
+
+        // Selection and expansion
+        while (!game.isOver()) {
+            game.generateMoves(w.moves);
+            int count = w.moves.size();
+            for (int i = 0; i < count; i++) w.legal[i] = NodePool::NONE;
+            for (uint32_t child = pool[node].firstChild; child != NodePool::NONE; child = pool[child].nextSibling) {
+                uint32_t key = pool[child].key;
+                for (int i = 0; i < count; i++) {
+                    if (w.legal[i] == NodePool::NONE && moveKey(game, w.moves[i]) == key) {
+                        w.legal[i] = child;
+                        pool[child].availability++;
+                        break;
+                    }
+                }
+            }
+
+            int untried = 0;
+            for (int i = 0; i < count; i++) untried += w.legal[i] == NodePool::NONE;
+            if (untried) {
+                int pick = int(w.rng.below(uint32_t(untried)));
+                int i = 0;
+                while (w.legal[i] != NodePool::NONE || pick--) i++;
+                uint32_t child = pool.allocate();
+                pool[child].key = moveKey(game, w.moves[i]);
+                pool[child].player = uint8_t(game.getCurrentPlayer());
+                pool[child].availability = 1;
+                pool[child].nextSibling = pool[node].firstChild;
+                pool[node].firstChild = child;
+                game.applyMove(w.moves[i]);
+                w.path.push_back(child);
+                break;
+            }
+
+            // The child's stored move may name another hand slot, so play
+            // the matching move of this determinization
+            int best = 0;
+            double bestScore = -1;
+            for (int i = 0; i < count; i++) {
+                const MctsNode& child = pool[w.legal[i]];
+                double score = child.reward / child.visits +
+                               config.exploration * std::sqrt(std::log(double(child.availability)) / child.visits);
+                if (score > bestScore) {
+                    bestScore = score;
+                    best = i;
+                }
+            }
+            game.applyMove(w.moves[best]);
+            node = w.legal[best];
+            w.path.push_back(node);
+        }
+
+        // Random playout
+        int turnLimit = game.getTurnCount() + config.playoutTurns;
+        while (!game.isOver() && game.getTurnCount() < turnLimit) {
+            game.generateMoves(w.moves);
+            game.applyMove(w.moves[w.rng.below(uint32_t(w.moves.size()))]);
+        }
+
+        int winner = game.getWinner();
+        for (uint32_t n : w.path) {
+            MctsNode& visited = pool[n];
+            visited.visits++;
+            visited.reward += winner < 0 ? 0.5f : winner == visited.player ? 1.0f : 0.0f;
+        }
+        w.playouts++;
+    }
+
+    void runWorker(Worker& w, const MonopolyDealGame& root, uint64_t playouts,
+                   std::chrono::steady_clock::time_point deadline) {
+        w.pool.reset();
+        w.pool.allocate();
+        w.playouts = 0;
+        while (config.seconds > 0 || w.playouts < playouts) {
+            if (config.seconds > 0 && (w.playouts & 15) == 0 && std::chrono::steady_clock::now() >= deadline) break;
+            iterate(w, root);
+        }
+    }
+
+public:
+    explicit MctsSearch(const MctsConfig& config = MctsConfig(), uint64_t seed = 1) : config(config), seed(seed) {
+        unsigned threads = config.threads ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+        workers.resize(threads);
+    }
+
+    const MctsConfig& getConfig() const { return config; }
+    uint64_t getPlayouts() const { return totalPlayouts; }
+    double getSeconds() const { return totalSeconds; }
+    double playoutsPerSecond() const { return totalSeconds > 0 ? totalPlayouts / totalSeconds : 0; }
+
+    // Returns the most visited of the game's legal moves for the player to move
+    Move search(const MonopolyDealGame& root) {
+        MoveList moves;
+        root.generateMoves(moves);
+        if (moves.size() <= 1) return moves.empty() ? Move::endTurn() : moves[0];
+
+        auto start = std::chrono::steady_clock::now();
+        auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                    std::chrono::duration<double>(config.seconds));
+        searches++;
+        for (size_t t = 0; t < workers.size(); t++) workers[t].rng.reseed(deriveSeed(seed, searches * 64 + t));
+
+        uint64_t share = (config.playouts + workers.size() - 1) / workers.size();
+        if (workers.size() == 1) {
+            runWorker(workers[0], root, share, deadline);
+        } else {
+            std::vector<std::thread> threads;
+            for (auto& w : workers) threads.emplace_back([&, share] { runWorker(w, root, share, deadline); });
+            for (auto& thread : threads) thread.join();
+        }
+
+        // Sum the root's children over every tree
+        uint64_t visits[MAX_MOVES] = {};
+        for (auto& w : workers) {
+            totalPlayouts += w.playouts;
+            for (uint32_t child = w.pool[0].firstChild; child != NodePool::NONE; child = w.pool[child].nextSibling) {
+                for (int i = 0; i < moves.size(); i++) {
+                    if (moveKey(root, moves[i]) == w.pool[child].key) {
+                        visits[i] += w.pool[child].visits;
+                        break;
+                    }
+                }
+            }
+        }
+        totalSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        int best = 0;
+        for (int i = 1; i < moves.size(); i++) {
+            if (visits[i] > visits[best]) best = i;
+        }
+        return moves[best];
+    }
+};
+
+// Plays every decision by running an MctsSearch
+class MctsPolicy : public MovePolicy {
+private:
+    MctsSearch searcher;
+
+protected:
+    Move chooseMove(const MonopolyDealGame& game) override { return searcher.search(game); }
+
+public:
+    explicit MctsPolicy(const MctsConfig& config = MctsConfig(), uint64_t seed = 1) : searcher(config, seed) {}
+
+    const MctsSearch& getSearch() const { return searcher; }
+};
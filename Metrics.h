@@ -0,0 +1,312 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Cards.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Timing of the engine's hot paths. Configure with -DMONOPOLY_METRICS=ON
+// (or define MONOPOLY_METRICS=1) to build the METRICS_SCOPE probes in;
+// otherwise they expand to nothing and the engine carries no cost at all.
+//
+// Each thread counts into its own block, merged into the process totals
+// when the thread exits, so probes never contend. Call the write functions
+// after the worker threads have joined.
+#ifndef MONOPOLY_METRICS
+#define MONOPOLY_METRICS 0
+#endif
+
+#if MONOPOLY_METRICS
+#define METRICS_JOIN2(a, b) a##b
+#define METRICS_JOIN(a, b) METRICS_JOIN2(a, b)
+#define METRICS_SCOPE(phase) ::metrics::ScopedTimer METRICS_JOIN(metricsScope, __LINE__)(phase)
+#else
+#define METRICS_SCOPE(phase) ((void)0)
+#endif
+
+namespace metrics {
+
+constexpr bool ENABLED = MONOPOLY_METRICS;
+
+enum class Phase : uint8_t {
+    DRAW,
+    RESHUFFLE,
+    PLAY_MONEY,
+    PLAY_PROPERTY,
+    PLAY_ACTION,
+    PLAY_RENT,
+    WIN_CHECK,
+    DISCARD,
+    BATCH_DECIDE,
+    BATCH_ADVANCE,
+    BATCH_SETS,
+    COUNT
+};
+
+constexpr int NUM_PHASES = int(Phase::COUNT);
+
+constexpr const char* PHASE_NAMES[NUM_PHASES] = {
+    "draw", "reshuffle", "play_money", "play_property", "play_action", "play_rent",
+    "win_check", "discard", "batch_decide", "batch_advance", "batch_sets",
+};
+
+inline Phase playPhase(CardType type) {
+    switch (type) {
+        case CardType::PROPERTY: return Phase::PLAY_PROPERTY;
+        case CardType::ACTION: return Phase::PLAY_ACTION;
+        case CardType::RENT: return Phase::PLAY_RENT;
+        default: return Phase::PLAY_MONEY;
+    }
+}
+
+// Playing hand[index], which may not exist yet when the move is illegal
+template <class Hand>
+Phase playPhase(const Hand& hand, size_t index) {
+    return index < hand.size() ? playPhase(cardInfo(hand[index]).type) : Phase::PLAY_MONEY;
+}
+
+// Bucket b counts times under 2^b ns; the last one takes everything longer
+constexpr int BUCKETS = 32;
+
+inline int bucketOf(uint64_t ns) {
+    int bucket = ns ? 64 - __builtin_clzll(ns) : 0;
+    return bucket < BUCKETS ? bucket : BUCKETS - 1;
+}
+
+// Threads count in ticks; snapshot() hands out nanoseconds
+struct Counters {
+    std::array<uint64_t, NUM_PHASES> count{};
+    std::array<uint64_t, NUM_PHASES> totalNs{};
+    std::array<std::array<uint64_t, BUCKETS>, NUM_PHASES> histogram{};
+
+    void add(const Counters& other) {
+        for (int p = 0; p < NUM_PHASES; p++) {
+            count[p] += other.count[p];
+            totalNs[p] += other.totalNs[p];
+            for (int b = 0; b < BUCKETS; b++) histogram[p][b] += other.histogram[p][b];
+        }
+    }
+
+    // Upper bound of the bucket holding the q-th quantile
+    uint64_t quantileNs(int p, double q) const {
+        if (!count[p]) return 0;
+        uint64_t rank = uint64_t(q * count[p]), seen = 0;
+        for (int b = 0; b < BUCKETS; b++) {
+            seen += histogram[p][b];
+            if (seen > rank) return 1ULL << b;
+        }
+        return 1ULL << (BUCKETS - 1);
+    }
+};
+
+// One complete span for the trace file, in ticks
+struct TraceEvent {
+    uint64_t start;
+    uint32_t duration;
+    Phase phase;
+};
+
+// Per thread, so a long run cannot use unbounded memory (16 MB each)
+constexpr size_t MAX_TRACE_EVENTS = 1 << 20;
+
+using Clock = std::chrono::steady_clock;
+
+// The probes read the time stamp counter where there is one: a clock read
+// would cost more than most of the phases it times. Ticks become
+// nanoseconds only when a report is written.
+inline uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+#endif
+}
+
+namespace detail {
+
+struct ThreadTrace {
+    uint32_t thread;
+    std::vector<TraceEvent> events;
+};
+
+struct Registry {
+    std::mutex lock;
+    Counters merged;
+    std::vector<ThreadTrace> traces;
+    uint64_t droppedEvents = 0;
+    uint32_t nextThread = 0;
+    std::atomic<bool> tracing{false};
+    Clock::time_point epoch = Clock::now();
+    uint64_t epochTicks = ticks();
+
+    double nsPerTick() const {
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - epoch).count();
+        uint64_t elapsed = ticks() - epochTicks;
+        return elapsed ? ns / elapsed : 1.0;
+    }
+};
+
+inline Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+struct ThreadMetrics {
+    Counters counters;
+    std::vector<TraceEvent> trace;
+    uint64_t dropped = 0;
+    uint32_t thread;
+
+    ThreadMetrics() {
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> guard(shared.lock);
+        thread = shared.nextThread++;
+    }
+    ~ThreadMetrics() { flush(); }
+
+    void flush() {
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> guard(shared.lock);
+        shared.merged.add(counters);
+        counters = Counters{};
+        if (!trace.empty()) shared.traces.push_back({thread, std::move(trace)});
+        trace.clear();
+        shared.droppedEvents += dropped;
+        dropped = 0;
+    }
+};
+
+inline ThreadMetrics& local() {
+    thread_local ThreadMetrics metrics;
+    return metrics;
+}
+
+} // namespace detail
+
+// Also keep every span for writeTrace, from now on
+inline void enableTrace() { detail::registry().tracing = true; }
+
+inline void record(Phase phase, uint64_t start, uint64_t end) {
+    detail::ThreadMetrics& metrics = detail::local();
+    uint64_t elapsed = end - start;
+    int p = int(phase);
+    metrics.counters.count[p]++;
+    metrics.counters.totalNs[p] += elapsed;
+    metrics.counters.histogram[p][bucketOf(elapsed)]++;
+    if (detail::registry().tracing.load(std::memory_order_relaxed)) {
+        if (metrics.trace.size() >= MAX_TRACE_EVENTS) metrics.dropped++;
+        else metrics.trace.push_back({start, uint32_t(elapsed), phase});
+    }
+}
+
+class ScopedTimer {
+private:
+    Phase phase;
+    uint64_t start;
+
+public:
+    explicit ScopedTimer(Phase phase) : phase(phase), start(ticks()) {}
+    ~ScopedTimer() { record(phase, start, ticks()); }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+// Totals of every thread that has exited, plus the calling thread, in ns.
+// Histograms are rebucketed by their bounds, so they stay approximate.
+inline Counters snapshot() {
+    detail::local().flush();
+    detail::Registry& shared = detail::registry();
+    double scale = shared.nsPerTick();
+    std::lock_guard<std::mutex> guard(shared.lock);
+    Counters totals;
+    for (int p = 0; p < NUM_PHASES; p++) {
+        totals.count[p] = shared.merged.count[p];
+        totals.totalNs[p] = uint64_t(shared.merged.totalNs[p] * scale);
+        for (int b = 0; b < BUCKETS; b++) {
+            totals.histogram[p][bucketOf(uint64_t(((1ULL << b) - 1) * scale))] += shared.merged.histogram[p][b];
+        }
+    }
+    return totals;
+}
+
+// {"phases": [{"name", "count", "total_ns", "mean_ns", "p50_ns", "p99_ns", "histogram"}]}
+// where histogram[b] counts spans under 2^b ns
+inline bool writeJson(const std::string& path) {
+    Counters totals = snapshot();
+    std::ofstream out(path);
+    out << "{\n  \"enabled\": " << (ENABLED ? "true" : "false") << ",\n  \"phases\": [\n";
+    for (int p = 0; p < NUM_PHASES; p++) {
+        out << "    {\"name\": \"" << PHASE_NAMES[p] << "\", \"count\": " << totals.count[p]
+            << ", \"total_ns\": " << totals.totalNs[p]
+            << ", \"mean_ns\": " << (totals.count[p] ? double(totals.totalNs[p]) / totals.count[p] : 0.0)
+            << ", \"p50_ns\": " << totals.quantileNs(p, 0.5) << ", \"p99_ns\": " << totals.quantileNs(p, 0.99)
+            << ", \"histogram\": [";
+        for (int b = 0; b < BUCKETS; b++) out << (b ? ", " : "") << totals.histogram[p][b];
+        out << "]}" << (p + 1 < NUM_PHASES ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return bool(out);
+}
+
+// Prometheus text exposition format: a counter and a histogram per phase
+inline bool writePrometheus(const std::string& path) {
+    Counters totals = snapshot();
+    std::ofstream out(path);
+    out << "# HELP monopoly_phase_total Times each engine phase ran.\n";
+    out << "# TYPE monopoly_phase_total counter\n";
+    for (int p = 0; p < NUM_PHASES; p++) {
+        out << "monopoly_phase_total{phase=\"" << PHASE_NAMES[p] << "\"} " << totals.count[p] << "\n";
+    }
+    out << "# HELP monopoly_phase_seconds Time spent in each engine phase.\n";
+    out << "# TYPE monopoly_phase_seconds histogram\n";
+    for (int p = 0; p < NUM_PHASES; p++) {
+        uint64_t cumulative = 0;
+        for (int b = 0; b + 1 < BUCKETS; b++) {
+            cumulative += totals.histogram[p][b];
+            out << "monopoly_phase_seconds_bucket{phase=\"" << PHASE_NAMES[p] << "\",le=\"" << double(1ULL << b) * 1e-9
+                << "\"} " << cumulative << "\n";
+        }
+        out << "monopoly_phase_seconds_bucket{phase=\"" << PHASE_NAMES[p] << "\",le=\"+Inf\"} " << totals.count[p] << "\n";
+        out << "monopoly_phase_seconds_sum{phase=\"" << PHASE_NAMES[p] << "\"} " << double(totals.totalNs[p]) * 1e-9 << "\n";
+        out << "monopoly_phase_seconds_count{phase=\"" << PHASE_NAMES[p] << "\"} " << totals.count[p] << "\n";
+    }
+    return bool(out);
+}
+
+// Chrome trace-event JSON (chrome://tracing, Perfetto): one complete event
+// per span, one track per thread
+inline bool writeTrace(const std::string& path) {
+    snapshot();
+    detail::Registry& shared = detail::registry();
+    double scale = shared.nsPerTick() / 1000;
+    std::lock_guard<std::mutex> guard(shared.lock);
+    std::ofstream out(path);
+    out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+    bool first = true;
+    char line[160];
+    for (const auto& trace : shared.traces) {
+        for (const TraceEvent& event : trace.events) {
+            snprintf(line, sizeof(line), "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                     first ? "" : ",\n", PHASE_NAMES[int(event.phase)], trace.thread,
+                     double(event.start > shared.epochTicks ? event.start - shared.epochTicks : 0) * scale, event.duration * scale);
+            out << line;
+            first = false;
+        }
+    }
+    out << "\n], \"otherData\": {\"dropped_events\": " << shared.droppedEvents << "}}\n";
+    return bool(out);
+}
+
+} // namespace metrics
@@ -0,0 +1,969 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include "Cards.h"
+#include "Metrics.h"
+#include "Moves.h"
+#include "Rng.h"
+#include "Rules.h"
+#include "Tableau.h"
+#include "Zobrist.h"
+
+template <class Rules> class BasicPlayer;
+template <class Rules> class BasicMonopolyDealGame;
+
+// Every choice the rules need from a player. The engine never reads input
+// itself; the terminal, bots and the batch simulator all plug in here.
+template <class Rules>
+class BasicDecisionPolicy {
+public:
+    using Player = BasicPlayer<Rules>;
+    using MonopolyDealGame = BasicMonopolyDealGame<Rules>;
+
+    virtual ~BasicDecisionPolicy() = default;
+
+    // Hand index to play, or -1 to end the turn
+    virtual int choosePlay(const MonopolyDealGame& game, const Player& self) = 0;
+    // Index into the colors the wild card allows
+    virtual int chooseWildColor(const Player& self, CardId card, const ColorList& colors) = 0;
+    // Indices into the candidate lists built by the rules
+    virtual int chooseSetToSteal(const Player& self, const ColorList& sets) = 0;
+    virtual int choosePropertyToSteal(const Player& self, const ColorList& props) = 0;
+    virtual int choosePropertyToGive(const Player& self, const ColorList& props) = 0;
+    virtual int choosePropertyToTake(const Player& self, const ColorList& props) = 0;
+    // Hand index to discard while over the hand limit
+    virtual int chooseDiscard(const MonopolyDealGame& game, const Player& self) = 0;
+};
+
+// Optional listener for everything that happens in a game. A game without
+// an observer runs fully headless.
+template <class Rules>
+class BasicGameObserver {
+public:
+    using Player = BasicPlayer<Rules>;
+    using MonopolyDealGame = BasicMonopolyDealGame<Rules>;
+
+    virtual ~BasicGameObserver() = default;
+
+    virtual void onGameStart(const MonopolyDealGame&) {}
+    virtual void onTurnStart(const Player&) {}
+    virtual void onReshuffle() {}
+    virtual void onDraw(const Player&, CardId) {}
+    virtual void onDrawPileEmpty() {}
+    // Called before the current player is asked to play or discard
+    virtual void onDecision(const Player&) {}
+    virtual void onInvalidPlay(const Player&) {}
+    // A legal move was accepted. Comes before any draws the move leads to.
+    virtual void onMove(const Player&, const Move&) {}
+    // The opponent charged rent, and what they paid
+    virtual void onRentBlocked(const Player&) {}
+    virtual void onRentCollected(const Player&, int) {}
+    virtual void onNoSetsToSteal() {}
+    virtual void onSetStolen(PropertyColor) {}
+    virtual void onNoPropertiesToSteal() {}
+    virtual void onPropertyStolen(PropertyColor) {}
+    virtual void onNotEnoughToTrade() {}
+    virtual void onTraded() {}
+    virtual void onWin(const Player&) {}
+};
+
+enum class GamePhase : uint8_t { NOT_STARTED, PLAY, DISCARD, OVER };
+
+// Cards one move can draw: only the first turn it begins with cards to
+// draw takes any, and it ends the search for a turn to play
+constexpr int MAX_MOVE_DRAWS = 8;
+
+// Everything applyMove changed, so undoMove can put it back exactly.
+// Small enough to keep one per ply on a search stack.
+struct UndoRecord {
+    Move move;
+    CardId card;
+    GamePhase phase;
+    uint8_t currentPlayer;
+    uint8_t playsThisTurn;
+    int8_t winner;
+    bool hadJustSayNo;
+    uint8_t money;
+    uint8_t opponentMoney;
+    uint16_t listed;
+    uint16_t opponentListed;
+    int turnCount;
+    // Deal Breaker: our real cards of the stolen color before they were replaced
+    uint8_t savedCount;
+    std::array<CardId, MAX_COLOR_CARDS> savedCards;
+    // Turns begun after the move, the cards each one drew, and whether each
+    // drawing player held a Just Say No before drawing (bit per turn)
+    uint8_t turnsBegun;
+    uint8_t totalDraws;
+    uint8_t justSayNoBefore;
+    std::array<uint8_t, MAX_SEATS> turnDraws;
+    // Draw number before which the discard pile became the draw pile, or
+    // -1; where each draw's card came from; the RNG before the first draw
+    int8_t reshuffleAt;
+    std::array<uint8_t, MAX_MOVE_DRAWS> drawnFrom;
+    Xoshiro256 rngBefore;
+};
+
+// Draws named by the caller instead of picked by the RNG, for searches that
+// treat each draw as a chance node (see Endgame.h). Once the named cards
+// run out, further draws take the top card and set `overrun`, keeping a
+// copy of the pile the first of them would have been picked from.
+struct DrawScript {
+    const CardId* cards = nullptr;
+    uint8_t count = 0;
+    uint8_t used = 0;
+    bool overrun = false;
+    CardPile pile;
+};
+
+template <class Rules>
+class BasicPlayer {
+public:
+    using Player = BasicPlayer;
+    using PropertyTableau = BasicPropertyTableau<Rules>;
+    using DecisionPolicy = BasicDecisionPolicy<Rules>;
+    using GameObserver = BasicGameObserver<Rules>;
+
+private:
+    std::string name;
+    CardPile hand;
+    PropertyTableau properties;
+    int money;
+    bool hasJustSayNo;
+    uint8_t seat;
+    uint64_t handHash;
+
+public:
+    BasicPlayer(std::string n, int seat = 0)
+        : name(std::move(n)), properties(seat), money(0), hasJustSayNo(false), seat(uint8_t(seat)), handHash(0) {}
+
+    const std::string& getName() const { return name; }
+    const CardPile& getHand() const { return hand; }
+    const PropertyTableau& getProperties() const { return properties; }
+    int getMoney() const { return money; }
+    bool hasJustSayNoCard() const { return hasJustSayNo; }
+    int getSeat() const { return seat; }
+
+    // This player's share of the position hash
+    uint64_t hash() const {
+        return handHash ^ properties.hash() ^ moneyKey(seat, money) ^ (hasJustSayNo ? ZOBRIST.justSayNo[seat] : 0);
+    }
+
+    void addToHand(CardId card) {
+        hand.push_back(card);
+        handHash ^= ZOBRIST.hand[seat][card];
+        if (cardInfo(card).action == ActionKind::JUST_SAY_NO) hasJustSayNo = true;
+    }
+
+    CardId discard(size_t index) {
+        CardId card = hand[index];
+        hand.erase(index);
+        handHash ^= ZOBRIST.hand[seat][card];
+        return card;
+    }
+
+    // Undo helpers: put a discarded card back, or take back the last draw
+    void returnToHand(size_t index, CardId card) {
+        hand.insert(index, card);
+        handHash ^= ZOBRIST.hand[seat][card];
+    }
+
+    CardId takeBackDraw(bool hadJustSayNo) {
+        CardId card = hand.back();
+        hand.pop_back();
+        handHash ^= ZOBRIST.hand[seat][card];
+        hasJustSayNo = hadJustSayNo;
+        return card;
+    }
+
+    // Puts back a saved hand, table, money and Just Say No (see Snapshot.h)
+    void restore(const CardPile& cards, const PropertyTableau& table, int newMoney, bool justSayNo) {
+        handHash = 0;
+        for (CardId card : cards) handHash ^= ZOBRIST.hand[seat][card];
+        hand = cards;
+        properties = table;
+        money = newMoney;
+        hasJustSayNo = justSayNo;
+    }
+
+    // Swaps in a sampled hand of the same size (search determinization).
+    // Whether it holds a Just Say No is read off the new cards.
+    void replaceHand(const CardId* cards) {
+        hasJustSayNo = false;
+        for (size_t i = 0; i < hand.size(); i++) {
+            handHash ^= ZOBRIST.hand[seat][hand[i]] ^ ZOBRIST.hand[seat][cards[i]];
+            hand[i] = cards[i];
+            if (cardInfo(cards[i]).action == ActionKind::JUST_SAY_NO) hasJustSayNo = true;
+        }
+    }
+
+    bool operator==(const Player& other) const {
+        return name == other.name && hand == other.hand && properties == other.properties &&
+               money == other.money && hasJustSayNo == other.hasJustSayNo && seat == other.seat &&
+               handHash == other.handHash;
+    }
+    bool operator!=(const Player& other) const { return !(*this == other); }
+
+    bool isCompleteSet(PropertyColor color) const {
+        return properties.isComplete(color);
+    }
+
+    int getCompleteSetCount() const { return properties.completeSets(); }
+
+    ColorList getCompleteSets() const {
+        ColorList complete;
+        for (int c = 0; c < NUM_COLORS; c++) {
+            if (properties.completeMask() & (1u << c)) complete.push_back(PropertyColor(c));
+        }
+        return complete;
+    }
+
+    ColorList getStealableProperties(bool completeOnly) const {
+        ColorList stealable;
+        for (int c = 0; c < NUM_COLORS; c++) {
+            PropertyColor color = PropertyColor(c);
+            if (!properties.isListed(color)) continue;
+            if ((completeOnly && isCompleteSet(color)) ||
+                (!completeOnly && properties.count(color) > 0)) {
+                stealable.push_back(color);
+            }
+        }
+        return stealable;
+    }
+
+    // Asks the policy for whatever targets the card at `index` needs and
+    // turns the answers into a Move. False if the card cannot be played.
+    bool resolvePlay(int index, const Player& opponent, DecisionPolicy& policy, GameObserver* observer, Move& move) const {
+        if (index < 0 || index >= int(hand.size())) return false;
+
+        CardId card = hand[index];
+        const CardInfo& info = cardInfo(card);
+        move = Move::play(index);
+
+        if (info.isWild) {
+            ColorList colors;
+            for (PropertyColor color : info.wildColors) colors.push_back(color);
+            int choice = policy.chooseWildColor(*this, card, colors);
+            if (choice < 0 || choice >= int(colors.size())) return false;
+            move.color = colors[choice];
+        }
+        else if (info.action == ActionKind::DEAL_BREAKER) {
+            auto sets = opponent.getCompleteSets();
+            if (sets.empty()) {
+                if (observer) observer->onNoSetsToSteal();
+                return false;
+            }
+            int choice = policy.chooseSetToSteal(*this, sets);
+            if (choice < 0 || choice >= int(sets.size())) return false;
+            move.color = sets[choice];
+        }
+        else if (info.action == ActionKind::SLY_DEAL) {
+            auto props = opponent.getStealableProperties(false);
+            if (props.empty()) {
+                if (observer) observer->onNoPropertiesToSteal();
+                return false;
+            }
+            int choice = policy.choosePropertyToSteal(*this, props);
+            if (choice < 0 || choice >= int(props.size())) return false;
+            move.color = props[choice];
+        }
+        else if (info.action == ActionKind::FORCED_DEAL) {
+            auto myProps = getStealableProperties(false);
+            auto theirProps = opponent.getStealableProperties(false);
+
+            if (myProps.empty() || theirProps.empty()) {
+                if (observer) observer->onNotEnoughToTrade();
+                return false;
+            }
+
+            int myChoice = policy.choosePropertyToGive(*this, myProps);
+            int theirChoice = policy.choosePropertyToTake(*this, theirProps);
+
+            if (myChoice < 0 || myChoice >= int(myProps.size()) ||
+                theirChoice < 0 || theirChoice >= int(theirProps.size())) return false;
+            move.color = myProps[myChoice];
+            move.take = theirProps[theirChoice];
+        }
+        return true;
+    }
+
+    // Appends every legal play from this hand, one per card kind and target.
+    // Mirrors the checks in playCard and never allocates.
+    void addLegalPlays(const Player& opponent, MoveList& moves) const {
+        uint64_t seen = 0;
+        for (size_t i = 0; i < hand.size(); i++) {
+            uint64_t kind = 1ULL << cardKind(hand[i]);
+            if (seen & kind) continue;
+            seen |= kind;
+
+            const CardInfo& info = cardInfo(hand[i]);
+            switch(info.type) {
+                case CardType::MONEY:
+                    moves.push_back(Move::play(i));
+                    break;
+
+                case CardType::PROPERTY:
+                    if (info.isWild) {
+                        for (PropertyColor color : info.wildColors) moves.push_back(Move::play(i, color));
+                    } else {
+                        moves.push_back(Move::play(i));
+                    }
+                    break;
+
+                case CardType::RENT:
+                    if (!opponent.hasJustSayNo) moves.push_back(Move::play(i));
+                    break;
+
+                case CardType::ACTION:
+                    if (info.action == ActionKind::DEAL_BREAKER) {
+                        addColorTargets(i, opponent.properties.completeMask(), moves);
+                    }
+                    else if (info.action == ActionKind::SLY_DEAL) {
+                        addColorTargets(i, opponent.properties.occupiedMask(), moves);
+                    }
+                    else if (info.action == ActionKind::FORCED_DEAL) {
+                        uint16_t theirs = opponent.properties.occupiedMask();
+                        if (!theirs) break;
+                        for (uint16_t mine = properties.occupiedMask(); mine; mine &= mine - 1) {
+                            PropertyColor give = PropertyColor(__builtin_ctz(mine));
+                            for (uint16_t take = theirs; take; take &= take - 1) {
+                                moves.push_back(Move::play(i, give, PropertyColor(__builtin_ctz(take))));
+                            }
+                        }
+                    }
+                    else {
+                        moves.push_back(Move::play(i));
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+        }
+    }
+
+    // Applies a fully resolved play. Returns false, changing nothing, if the
+    // card or its targets are not legal right now.
+    bool playCard(const Move& move, Player& opponent, GameObserver* observer) {
+        if (move.handIndex >= hand.size()) return false;
+
+        CardId card = hand[move.handIndex];
+        const CardInfo& info = cardInfo(card);
+
+        switch(info.type) {
+            case CardType::MONEY:
+                money += info.value;
+                break;
+
+            case CardType::PROPERTY:
+                if (info.isWild) {
+                    if (!wildAllows(card, move.color)) return false;
+                    properties.addWild(card, move.color);
+                } else {
+                    properties.add(card, info.color);
+                }
+                break;
+
+            case CardType::RENT: {
+                if (opponent.hasJustSayNoCard()) {
+                    if (observer) observer->onRentBlocked(opponent);
+                    return false;
+                }
+                int rent = std::min(properties.rent(), opponent.money);
+                money += rent;
+                opponent.money -= rent;
+                if (observer) observer->onRentCollected(opponent, rent);
+                break;
+            }
+
+            case CardType::ACTION:
+                if (info.action == ActionKind::DEAL_BREAKER) {
+                    if (!opponent.isCompleteSet(move.color)) return false;
+                    properties.takeSet(opponent.properties, move.color);
+                    if (observer) observer->onSetStolen(move.color);
+                }
+                else if (info.action == ActionKind::SLY_DEAL) {
+                    if (!isRealColor(move.color) || !opponent.properties.count(move.color)) return false;
+                    properties.add(opponent.properties.removeTop(move.color), move.color);
+                    if (observer) observer->onPropertyStolen(move.color);
+                }
+                else if (info.action == ActionKind::FORCED_DEAL) {
+                    PropertyColor give = move.color;
+                    PropertyColor take = move.take;
+                    if (!isRealColor(give) || !isRealColor(take) ||
+                        !properties.count(give) || !opponent.properties.count(take)) return false;
+
+                    opponent.properties.add(properties.removeTop(give), give);
+                    properties.add(opponent.properties.removeTop(take), take);
+
+                    if (observer) observer->onTraded();
+                }
+                break;
+
+            default:
+                return false;
+        }
+
+        discard(move.handIndex);
+        if (info.action == ActionKind::JUST_SAY_NO) hasJustSayNo = false;
+        return true;
+    }
+
+    // Saves what playCard is about to change
+    void recordPlay(const Move& move, const Player& opponent, UndoRecord& undo) const {
+        undo.card = hand[move.handIndex];
+        undo.hadJustSayNo = hasJustSayNo;
+        undo.money = uint8_t(money);
+        undo.opponentMoney = uint8_t(opponent.money);
+        undo.listed = properties.listedMask();
+        undo.opponentListed = opponent.properties.listedMask();
+        undo.savedCount = 0;
+        if (cardInfo(undo.card).action == ActionKind::DEAL_BREAKER) {
+            undo.savedCount = uint8_t(properties.count(move.color));
+            for (size_t i = 0; i < undo.savedCount; i++) undo.savedCards[i] = properties.card(move.color, i);
+        }
+    }
+
+    // Reverses a successful playCard recorded by recordPlay
+    void undoPlay(const UndoRecord& undo, Player& opponent) {
+        const Move& move = undo.move;
+        const CardInfo& info = cardInfo(undo.card);
+
+        if (info.type == CardType::PROPERTY) {
+            if (info.isWild) properties.removeLastWild();
+            else properties.removeTop(info.color);
+        }
+        else if (info.action == ActionKind::DEAL_BREAKER) {
+            PropertyColor color = move.color;
+            CardId theirs[MAX_COLOR_CARDS];
+            size_t count = properties.count(color);
+            for (size_t i = 0; i < count; i++) theirs[i] = properties.card(color, i);
+            opponent.properties.replaceColor(color, theirs, count);
+            properties.replaceColor(color, undo.savedCards.data(), undo.savedCount);
+        }
+        else if (info.action == ActionKind::SLY_DEAL) {
+            opponent.properties.add(properties.removeTop(move.color), move.color);
+        }
+        else if (info.action == ActionKind::FORCED_DEAL) {
+            opponent.properties.add(properties.removeTop(move.take), move.take);
+            properties.add(opponent.properties.removeTop(move.color), move.color);
+        }
+
+        properties.restoreListed(undo.listed);
+        opponent.properties.restoreListed(undo.opponentListed);
+        money = undo.money;
+        opponent.money = undo.opponentMoney;
+        returnToHand(move.handIndex, undo.card);
+        hasJustSayNo = undo.hadJustSayNo;
+    }
+
+private:
+    static bool isRealColor(PropertyColor color) { return color < PropertyColor::NONE; }
+
+    static void addColorTargets(size_t index, uint16_t colors, MoveList& moves) {
+        for (; colors; colors &= colors - 1) {
+            moves.push_back(Move::play(index, PropertyColor(__builtin_ctz(colors))));
+        }
+    }
+};
+
+// The whole game as a state machine: generateMoves lists what the current
+// player may do, applyMove advances to the next decision. playGame drives it
+// with one DecisionPolicy per seat. Every limit comes from Rules (see
+// Rules.h) at compile time; MonopolyDealGame is the standard game.
+template <class Rules>
+class BasicMonopolyDealGame {
+public:
+    using MonopolyDealGame = BasicMonopolyDealGame;
+    using Player = BasicPlayer<Rules>;
+    using DecisionPolicy = BasicDecisionPolicy<Rules>;
+    using GameObserver = BasicGameObserver<Rules>;
+
+    static_assert(validRules<Rules>(), "rules out of range");
+    static_assert(Rules::DRAWS_PER_TURN <= MAX_MOVE_DRAWS, "an undo record cannot hold a turn's draws");
+    static_assert(maxHandSize<Rules>() <= MAX_HAND_CARDS, "a hand could outgrow MoveList");
+
+private:
+    std::vector<Player> players;
+    std::vector<DecisionPolicy*> policies;
+    GameObserver* observer;
+    // The draw and discard piles. A reshuffle swaps their roles instead of
+    // copying the discards across, and the draw pile is shuffled one card
+    // at a time as it is drawn (see drawCard).
+    std::array<CardPile, 2> piles;
+    uint8_t drawSide;
+    uint64_t seed;
+    Xoshiro256 rng;
+    size_t currentPlayer;
+    GamePhase phase;
+    int playsThisTurn;
+    int winner;
+    int turnCount;
+    int maxTurns;
+    // Hash of which cards are in the draw and discard piles
+    uint64_t pileHash;
+    // While applyMove is recording an undo, the turn changes it causes go here
+    UndoRecord* recording;
+    // While set, draws follow it instead of the RNG
+    DrawScript* script;
+
+    CardPile& drawPile() { return piles[drawSide]; }
+    CardPile& discardPile() { return piles[drawSide ^ 1]; }
+    const CardPile& drawPile() const { return piles[drawSide]; }
+    const CardPile& discardPile() const { return piles[drawSide ^ 1]; }
+
+    // The discards become the draw pile. Nothing is shuffled yet: drawCard
+    // picks each card at random as it is drawn.
+    void reshuffle() {
+        if (drawPile().empty() && !discardPile().empty()) {
+            METRICS_SCOPE(metrics::Phase::RESHUFFLE);
+            if (observer) observer->onReshuffle();
+            if (recording) recording->reshuffleAt = int8_t(recording->totalDraws);
+            flipPiles();
+        }
+    }
+
+    // Swaps the roles of the two piles (reshuffle, and undoing it)
+    void flipPiles() {
+        for (CardId card : discardPile()) pileHash ^= ZOBRIST.discardPile[card] ^ ZOBRIST.drawPile[card];
+        for (CardId card : drawPile()) pileHash ^= ZOBRIST.discardPile[card] ^ ZOBRIST.drawPile[card];
+        drawSide ^= 1;
+    }
+
+    // Takes the top card after moving a random one there, the next step of
+    // a Fisher-Yates shuffle of the pile. A seed deals the same cards as
+    // shuffling the whole pile first and drawing from the top.
+    CardId drawCard() {
+        if (recording && recording->totalDraws == 0) recording->rngBefore = rng;
+        size_t from = script ? scriptedDraw() : shuffleTop(drawPile(), rng);
+        if (recording) recording->drawnFrom[recording->totalDraws] = uint8_t(from);
+        CardId card = drawPile().back();
+        drawPile().pop_back();
+        return card;
+    }
+
+    // Moves the script's next card to the top of the draw pile, returning
+    // where it was. A card not in the pile, or a draw past the script, takes
+    // the top card as it is.
+    size_t scriptedDraw() {
+        CardPile& pile = drawPile();
+        size_t top = pile.size() - 1, from = top;
+        if (script->used < script->count) {
+            CardId wanted = script->cards[script->used++];
+            for (size_t i = 0; i < pile.size(); i++) {
+                if (pile[i] == wanted) from = i;
+            }
+        }
+        else if (!script->overrun) {
+            script->overrun = true;
+            script->pile = pile;
+        }
+        std::swap(pile[top], pile[from]);
+        return from;
+    }
+
+    Player& opponentOf(size_t player) { return players[(player + 1) % players.size()]; }
+
+    // Moves to the next player with cards to play, drawing DRAWS_PER_TURN
+    // cards at the start of each turn. A turn with an empty hand goes
+    // straight to the win check.
+    void beginTurn() {
+        while (true) {
+            if (maxTurns > 0 && turnCount >= maxTurns) {
+                phase = GamePhase::OVER;
+                return;
+            }
+            Player& current = players[currentPlayer];
+            turnCount++;
+            playsThisTurn = 0;
+
+            if (observer) observer->onTurnStart(current);
+            if (recording) {
+                if (current.hasJustSayNoCard()) recording->justSayNoBefore |= 1u << recording->turnsBegun;
+                recording->turnDraws[recording->turnsBegun++] = 0;
+            }
+
+            {
+                METRICS_SCOPE(metrics::Phase::DRAW);
+                for (int i = 0; i < Rules::DRAWS_PER_TURN; i++) {
+                    reshuffle();
+                    if (drawPile().empty()) {
+                        if (observer) observer->onDrawPileEmpty();
+                        break;
+                    }
+                    CardId card = drawCard();
+                    pileHash ^= ZOBRIST.drawPile[card];
+                    current.addToHand(card);
+                    if (observer) observer->onDraw(current, card);
+                    if (recording) {
+                        recording->turnDraws[recording->turnsBegun - 1]++;
+                        recording->totalDraws++;
+                    }
+                }
+            }
+
+            if (!current.getHand().empty()) {
+                phase = GamePhase::PLAY;
+                return;
+            }
+
+            if (checkWin()) return;
+            if (isStalemate()) {
+                phase = GamePhase::OVER;
+                return;
+            }
+            currentPlayer = (currentPlayer + 1) % players.size();
+        }
+    }
+
+    bool checkWin() {
+        METRICS_SCOPE(metrics::Phase::WIN_CHECK);
+        Player& current = players[currentPlayer];
+        if (current.getCompleteSetCount() < Rules::SETS_TO_WIN) return false;
+        winner = currentPlayer;
+        phase = GamePhase::OVER;
+        if (observer) observer->onWin(current);
+        return true;
+    }
+
+    // Nobody can ever play again: no cards in any hand or pile
+    bool isStalemate() const {
+        if (!drawPile().empty() || !discardPile().empty()) return false;
+        for (const auto& player : players) {
+            if (!player.getHand().empty()) return false;
+        }
+        return true;
+    }
+
+    void endPlayPhase() {
+        if (checkWin()) return;
+
+        // Discard down to the hand limit
+        if (players[currentPlayer].getHand().size() > Rules::HAND_LIMIT) {
+            phase = GamePhase::DISCARD;
+            return;
+        }
+        endTurn();
+    }
+
+    void endTurn() {
+        currentPlayer = (currentPlayer + 1) % players.size();
+        beginTurn();
+    }
+
+public:
+    // The seed fixes the whole deal, including every reshuffle
+    BasicMonopolyDealGame(const std::vector<std::string>& names, uint64_t seed)
+        : observer(nullptr), drawSide(0), seed(seed), rng(seed), currentPlayer(0), phase(GamePhase::NOT_STARTED),
+          playsThisTurn(0), winner(-1), turnCount(0), maxTurns(0), pileHash(0), recording(nullptr), script(nullptr) {
+        players.reserve(names.size());
+        for (const std::string& name : names) players.emplace_back(name, players.size());
+        policies.assign(players.size(), nullptr);
+        initializeDeck(drawPile());
+        dealInitialCards();
+        for (CardId card : drawPile()) pileHash ^= ZOBRIST.drawPile[card];
+    }
+
+    // The catalog's cards that the rules put in the deck
+    static void initializeDeck(CardPile& deck) {
+        deck.clear();
+        for (int id = 0; id < NUM_CARDS; id++) {
+            if (Rules::inDeck(CardId(id))) deck.push_back(CardId(id));
+        }
+    }
+
+    void setPolicy(size_t player, DecisionPolicy* policy) { policies[player] = policy; }
+    void setObserver(GameObserver* o) { observer = o; }
+    // Ends the game without a winner once this many turns have begun; 0 = never
+    void setMaxTurns(int turns) { maxTurns = turns; }
+
+    const std::vector<Player>& getPlayers() const { return players; }
+    size_t getCurrentPlayer() const { return currentPlayer; }
+    uint64_t getSeed() const { return seed; }
+    GamePhase getPhase() const { return phase; }
+    bool isOver() const { return phase == GamePhase::OVER; }
+    int getPlaysThisTurn() const { return playsThisTurn; }
+    int getWinner() const { return winner; }
+    int getTurnCount() const { return turnCount; }
+    int getMaxTurns() const { return maxTurns; }
+    const CardPile& getDrawPile() const { return drawPile(); }
+    const Xoshiro256& getRng() const { return rng; }
+    const CardPile& getDiscardPile() const { return discardPile(); }
+
+    void dealInitialCards() {
+        for (int i = 0; i < Rules::STARTING_CARDS; i++) {
+            for (auto& player : players) {
+                if (!drawPile().empty()) player.addToHand(drawCard());
+            }
+        }
+    }
+
+    // Puts back a saved position (see Snapshot.h): each player's cards and
+    // money through restorePlayer, then the piles, the RNG and the point in
+    // the turn here. The pile hash is rebuilt from the cards.
+    void restorePlayer(size_t player, const CardPile& hand, const PropertyTableau& table, int money, bool justSayNo) {
+        players[player].restore(hand, table, money, justSayNo);
+    }
+
+    void restoreTurn(const CardPile& draw, const CardPile& discard, const Xoshiro256& generator, uint64_t gameSeed,
+                     size_t current, GamePhase turnPhase, int plays, int winnerSeat, int turns, int turnLimit) {
+        drawSide = 0;
+        drawPile() = draw;
+        discardPile() = discard;
+        pileHash = 0;
+        for (CardId card : draw) pileHash ^= ZOBRIST.drawPile[card];
+        for (CardId card : discard) pileHash ^= ZOBRIST.discardPile[card];
+        rng = generator;
+        seed = gameSeed;
+        currentPlayer = current;
+        phase = turnPhase;
+        playsThisTurn = plays;
+        winner = winnerSeat;
+        turnCount = turns;
+        maxTurns = turnLimit;
+    }
+
+    // Redeals everything `viewer` cannot see (the other hands and the draw
+    // pile) at random, keeping every hand's size, and reseeds the deck so
+    // future draws are unknown too. Used by searches that sample the
+    // hidden information.
+    void determinize(size_t viewer, Xoshiro256& sampler) {
+        CardPile unseen = drawPile();
+        for (size_t p = 0; p < players.size(); p++) {
+            if (p == viewer) continue;
+            for (CardId card : players[p].getHand()) unseen.push_back(card);
+        }
+        shuffleCards(unseen, sampler);
+
+        size_t next = 0;
+        for (size_t i = 0; i < drawPile().size(); i++) {
+            pileHash ^= ZOBRIST.drawPile[drawPile()[i]] ^ ZOBRIST.drawPile[unseen[next]];
+            drawPile()[i] = unseen[next++];
+        }
+        for (size_t p = 0; p < players.size(); p++) {
+            if (p == viewer) continue;
+            players[p].replaceHand(unseen.begin() + next);
+            next += players[p].getHand().size();
+        }
+        rng.reseed(sampler());
+    }
+
+    // Starts the first turn. Set the observer first to see its draws.
+    void start() {
+        if (phase != GamePhase::NOT_STARTED) return;
+        if (observer) observer->onGameStart(*this);
+        beginTurn();
+    }
+
+    // Every legal move for the current player. Never allocates.
+    void generateMoves(MoveList& moves) const {
+        moves.clear();
+        const Player& current = players[currentPlayer];
+        if (phase == GamePhase::PLAY) {
+            current.addLegalPlays(players[(currentPlayer + 1) % players.size()], moves);
+            moves.push_back(Move::endTurn());
+        }
+        else if (phase == GamePhase::DISCARD) {
+            uint64_t seen = 0;
+            for (size_t i = 0; i < current.getHand().size(); i++) {
+                uint64_t kind = 1ULL << cardKind(current.getHand()[i]);
+                if (seen & kind) continue;
+                seen |= kind;
+                moves.push_back(Move::discard(i));
+            }
+        }
+    }
+
+    // Applies one move for the current player and advances the game to the
+    // next decision. Returns false, changing nothing, if the move is illegal.
+    bool applyMove(const Move& move) {
+        Player& current = players[currentPlayer];
+
+        if (phase == GamePhase::PLAY && move.type == MoveType::PLAY) {
+            bool played;
+            {
+                METRICS_SCOPE(metrics::playPhase(current.getHand(), move.handIndex));
+                played = current.playCard(move, opponentOf(currentPlayer), observer);
+            }
+            if (!played) return false;
+            if (observer) observer->onMove(current, move);
+            if (++playsThisTurn >= Rules::PLAYS_PER_TURN || current.getHand().empty()) endPlayPhase();
+            return true;
+        }
+        if (phase == GamePhase::PLAY && move.type == MoveType::END_TURN) {
+            if (observer) observer->onMove(current, move);
+            endPlayPhase();
+            return true;
+        }
+        if (phase == GamePhase::DISCARD && move.type == MoveType::DISCARD) {
+            if (move.handIndex >= current.getHand().size()) return false;
+            if (observer) observer->onMove(current, move);
+            {
+                METRICS_SCOPE(metrics::Phase::DISCARD);
+                CardId card = current.discard(move.handIndex);
+                discardPile().push_back(card);
+                pileHash ^= ZOBRIST.discardPile[card];
+            }
+            if (current.getHand().size() <= Rules::HAND_LIMIT) endTurn();
+            return true;
+        }
+        return false;
+    }
+
+    // applyMove that also fills `undo` so undoMove can take the move back.
+    // Lets a search walk the tree on one game object instead of copying it.
+    bool applyMove(const Move& move, UndoRecord& undo) {
+        undo.move = move;
+        undo.phase = phase;
+        undo.currentPlayer = uint8_t(currentPlayer);
+        undo.playsThisTurn = uint8_t(playsThisTurn);
+        undo.winner = int8_t(winner);
+        undo.turnCount = turnCount;
+        undo.turnsBegun = 0;
+        undo.totalDraws = 0;
+        undo.justSayNoBefore = 0;
+        undo.reshuffleAt = -1;
+
+        Player& current = players[currentPlayer];
+        if (move.type == MoveType::PLAY && move.handIndex < current.getHand().size()) {
+            current.recordPlay(move, opponentOf(currentPlayer), undo);
+        }
+        else if (move.type == MoveType::DISCARD && move.handIndex < current.getHand().size()) {
+            undo.card = current.getHand()[move.handIndex];
+        }
+
+        recording = &undo;
+        bool applied = applyMove(move);
+        recording = nullptr;
+        return applied;
+    }
+
+    // applyMove(move, undo) with the draws it leads to taken from `draws`.
+    // The RNG is left alone; undoMove takes it back like any other move.
+    bool applyMove(const Move& move, UndoRecord& undo, DrawScript& draws) {
+        script = &draws;
+        bool applied = applyMove(move, undo);
+        script = nullptr;
+        return applied;
+    }
+
+    // Takes back the most recent successful applyMove(move, undo)
+    void undoMove(const UndoRecord& undo) {
+        // Put back the cards drawn by the turns that began, newest first
+        int drawIndex = undo.totalDraws;
+        for (int t = undo.turnsBegun - 1; t >= 0; t--) {
+            Player& player = players[(undo.currentPlayer + 1 + t) % players.size()];
+            bool hadJustSayNo = undo.justSayNoBefore & (1u << t);
+            for (int d = 0; d < undo.turnDraws[t]; d++) {
+                CardId card = player.takeBackDraw(hadJustSayNo);
+                CardPile& pile = drawPile();
+                pile.push_back(card);
+                std::swap(pile[pile.size() - 1], pile[undo.drawnFrom[--drawIndex]]);
+                pileHash ^= ZOBRIST.drawPile[card];
+                if (drawIndex == undo.reshuffleAt) flipPiles();
+            }
+        }
+        if (undo.totalDraws) rng = undo.rngBefore;
+
+        currentPlayer = undo.currentPlayer;
+        phase = undo.phase;
+        playsThisTurn = undo.playsThisTurn;
+        winner = undo.winner;
+        turnCount = undo.turnCount;
+
+        Player& current = players[currentPlayer];
+        if (undo.move.type == MoveType::PLAY) {
+            current.undoPlay(undo, opponentOf(currentPlayer));
+        }
+        else if (undo.move.type == MoveType::DISCARD) {
+            discardPile().pop_back();
+            pileHash ^= ZOBRIST.discardPile[undo.card];
+            current.returnToHand(undo.move.handIndex, undo.card);
+        }
+    }
+
+    // Zobrist hash of the whole position: hands, tables, banks, piles (as
+    // sets, not in order) and whose move it is. Kept up to date incrementally.
+    uint64_t hash() const {
+        uint64_t h = pileHash ^ ZOBRIST.current[currentPlayer] ^ ZOBRIST.phase[int(phase)] ^
+                     ZOBRIST.plays[playsThisTurn] ^ (winner >= 0 ? ZOBRIST.won : 0);
+        for (const auto& player : players) h ^= player.hash();
+        return h;
+    }
+
+    // The same hash built from nothing, to check the incremental one
+    uint64_t recomputeHash() const {
+        uint64_t h = ZOBRIST.current[currentPlayer] ^ ZOBRIST.phase[int(phase)] ^
+                     ZOBRIST.plays[playsThisTurn] ^ (winner >= 0 ? ZOBRIST.won : 0);
+        for (CardId card : drawPile()) h ^= ZOBRIST.drawPile[card];
+        for (CardId card : discardPile()) h ^= ZOBRIST.discardPile[card];
+        for (const auto& player : players) {
+            int seat = player.getSeat();
+            const auto& table = player.getProperties();
+            for (CardId card : player.getHand()) h ^= ZOBRIST.hand[seat][card];
+            for (int c = 0; c < NUM_COLORS; c++) {
+                PropertyColor color = PropertyColor(c);
+                for (size_t i = 0; i < table.count(color); i++) h ^= ZOBRIST.table[seat][table.card(color, i)];
+                if (table.isListed(color)) h ^= ZOBRIST.listed[seat][c];
+            }
+            for (size_t i = 0; i < table.wildTotal(); i++) {
+                const WildCard& wild = table.wild(i);
+                h ^= ZOBRIST.wild[seat][wildOrdinal(wild.id)][int(wild.color)];
+            }
+            h ^= moneyKey(seat, player.getMoney());
+            if (player.hasJustSayNoCard()) h ^= ZOBRIST.justSayNo[seat];
+        }
+        return h;
+    }
+
+    // Same cards in the same places, same RNG and same point in the turn
+    bool sameState(const MonopolyDealGame& other) const {
+        return players == other.players && drawPile() == other.drawPile() && discardPile() == other.discardPile() &&
+               rng == other.rng && currentPlayer == other.currentPlayer && phase == other.phase &&
+               playsThisTurn == other.playsThisTurn && winner == other.winner && turnCount == other.turnCount &&
+               pileHash == other.pileHash;
+    }
+
+    // Runs until someone wins, or until maxTurns turns have been played when
+    // maxTurns > 0. Returns the winner's index, or -1 if the game was cut off.
+    int playGame(int maxTurns = 0) {
+        setMaxTurns(maxTurns);
+        start();
+
+        while (!isOver()) {
+            Player& current = players[currentPlayer];
+            DecisionPolicy& policy = *policies[currentPlayer];
+
+            if (observer) observer->onDecision(current);
+
+            if (phase == GamePhase::PLAY) {
+                int choice = policy.choosePlay(*this, current);
+                if (choice == -1) {
+                    applyMove(Move::endTurn());
+                    continue;
+                }
+                Move move;
+                if (!current.resolvePlay(choice, opponentOf(currentPlayer), policy, observer, move) || !applyMove(move)) {
+                    if (observer) observer->onInvalidPlay(current);
+                }
+            } else {
+                int choice = policy.chooseDiscard(*this, current);
+                if (choice >= 0 && choice < int(current.getHand().size())) {
+                    applyMove(Move::discard(choice));
+                }
+            }
+        }
+
+        return winner;
+    }
+};
+
+// The game under the standard rules
+using Player = BasicPlayer<StandardRules>;
+using MonopolyDealGame = BasicMonopolyDealGame<StandardRules>;
+using DecisionPolicy = BasicDecisionPolicy<StandardRules>;
+using GameObserver = BasicGameObserver<StandardRules>;
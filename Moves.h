@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include "Cards.h"
+#include "Rules.h"
+
+enum class MoveType : uint8_t { PLAY, END_TURN, DISCARD };
+
+// One complete decision, with every target it needs already chosen
+struct Move {
+    MoveType type;
+    uint8_t handIndex;
+    // Wild color, set or property to steal, or the property given in a Forced Deal
+    PropertyColor color;
+    // The property taken in a Forced Deal
+    PropertyColor take;
+
+    static Move play(size_t index, PropertyColor color = PropertyColor::NONE, PropertyColor take = PropertyColor::NONE) {
+        return {MoveType::PLAY, uint8_t(index), color, take};
+    }
+    static Move endTurn() { return {MoveType::END_TURN, 0, PropertyColor::NONE, PropertyColor::NONE}; }
+    static Move discard(size_t index) { return {MoveType::DISCARD, uint8_t(index), PropertyColor::NONE, PropertyColor::NONE}; }
+
+    bool operator==(const Move& other) const {
+        return type == other.type && handIndex == other.handIndex && color == other.color && take == other.take;
+    }
+    bool operator!=(const Move& other) const { return !(*this == other); }
+};
+
+// Even if every card of the largest hand were a Forced Deal with every color
+// on each side, plus ending the turn
+constexpr int MAX_MOVES = MAX_HAND_CARDS * NUM_COLORS * NUM_COLORS + 1;
+
+// Fixed-capacity move list meant to live on the stack. Constructing one
+// does not touch its storage, and nothing here ever allocates.
+class MoveList {
+private:
+    std::array<Move, MAX_MOVES> moves;
+    int count;
+
+public:
+    MoveList() : count(0) {}
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    void clear() { count = 0; }
+
+    // MAX_MOVES covers every legal position, so a full list is a bug
+    void push_back(const Move& move) {
+        assert(count < MAX_MOVES && "MoveList overflow");
+        moves[count++] = move;
+    }
+
+    const Move& operator[](int i) const { return moves[i]; }
+    const Move* begin() const { return moves.data(); }
+    const Move* end() const { return moves.data() + count; }
+};
@@ -0,0 +1,317 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "MonopolyDeal.h"
+#include "Rng.h"
+#include "WildSolver.h"
+
+// Picks uniformly among the cards in hand plus ending the turn. Works
+// under any rules.
+template <class Rules>
+class BasicRandomPolicy : public BasicDecisionPolicy<Rules> {
+private:
+    using Player = BasicPlayer<Rules>;
+    using MonopolyDealGame = BasicMonopolyDealGame<Rules>;
+
+    Xoshiro256 rng;
+
+    int pick(size_t count) { return int(rng.below(uint32_t(count))); }
+
+public:
+    explicit BasicRandomPolicy(uint64_t seed) : rng(seed) {}
+
+    void reseed(uint64_t seed) { rng.reseed(seed); }
+
+    int choosePlay(const MonopolyDealGame&, const Player& self) override {
+        int choice = pick(self.getHand().size() + 1);
+        return choice == int(self.getHand().size()) ? -1 : choice;
+    }
+    int chooseWildColor(const Player&, CardId, const ColorList& colors) override { return pick(colors.size()); }
+    int chooseSetToSteal(const Player&, const ColorList& sets) override { return pick(sets.size()); }
+    int choosePropertyToSteal(const Player&, const ColorList& props) override { return pick(props.size()); }
+    int choosePropertyToGive(const Player&, const ColorList& props) override { return pick(props.size()); }
+    int choosePropertyToTake(const Player&, const ColorList& props) override { return pick(props.size()); }
+    int chooseDiscard(const MonopolyDealGame&, const Player& self) override { return pick(self.getHand().size()); }
+};
+
+using RandomPolicy = BasicRandomPolicy<StandardRules>;
+
+// Base for bots that decide in whole moves (see generateMoves). The move
+// picked in choosePlay also answers the follow-up target questions.
+template <class Rules>
+class BasicMovePolicy : public BasicDecisionPolicy<Rules> {
+public:
+    using Player = BasicPlayer<Rules>;
+    using MonopolyDealGame = BasicMonopolyDealGame<Rules>;
+
+private:
+    Move pending = Move::endTurn();
+
+    static int indexOf(const ColorList& colors, PropertyColor color) {
+        for (size_t i = 0; i < colors.size(); i++) {
+            if (colors[i] == color) return int(i);
+        }
+        return -1;
+    }
+
+protected:
+    // Must return one of the game's legal moves
+    virtual Move chooseMove(const MonopolyDealGame& game) = 0;
+
+public:
+    int choosePlay(const MonopolyDealGame& game, const Player&) override {
+        pending = chooseMove(game);
+        return pending.type == MoveType::PLAY ? pending.handIndex : -1;
+    }
+    int chooseWildColor(const Player&, CardId, const ColorList& colors) override {
+        return indexOf(colors, pending.color);
+    }
+    int chooseSetToSteal(const Player&, const ColorList& sets) override { return indexOf(sets, pending.color); }
+    int choosePropertyToSteal(const Player&, const ColorList& props) override { return indexOf(props, pending.color); }
+    int choosePropertyToGive(const Player&, const ColorList& props) override { return indexOf(props, pending.color); }
+    int choosePropertyToTake(const Player&, const ColorList& props) override { return indexOf(props, pending.take); }
+    int chooseDiscard(const MonopolyDealGame& game, const Player&) override { return chooseMove(game).handIndex; }
+};
+
+using MovePolicy = BasicMovePolicy<StandardRules>;
+
+// A fixed-priority bot: Deal Breaker, then properties (wilds where
+// solveWilds puts them), Sly Deal, rent and money; it never plays Forced Deal
+// or Just Say No and discards its cheapest card. It reads the game through
+// a View so the batched simulator can run the exact same rules, see Batch.h;
+// its greedyPlay ranks cards from a table, so keep the two in step.
+// A View provides phase(), handSize(), hand(i), setCount(color) (own cards
+// toward a set, wilds included), isListed(color), opponentComplete(color),
+// opponentCount(color) (their real cards), rent(), opponentMoney() and
+// opponentHasJustSayNo().
+template <class View>
+Move greedyMove(const View& view) {
+    if (view.phase() == GamePhase::DISCARD) {
+        size_t cheapest = 0;
+        for (size_t i = 1; i < view.handSize(); i++) {
+            if (cardInfo(view.hand(i)).value < cardInfo(view.hand(cheapest)).value) cheapest = i;
+        }
+        return Move::discard(cheapest);
+    }
+
+    Move best = Move::endTurn();
+    int bestRank = 0;
+    bool solved = false;
+    WildAssignment wilds{};
+    for (size_t i = 0; i < view.handSize(); i++) {
+        const CardInfo& info = cardInfo(view.hand(i));
+        Move move = Move::play(i);
+        int rank = 0;
+        if (info.type == CardType::PROPERTY && info.isWild) {
+            if (!solved) {
+                WildProblem problem{};
+                for (int c = 0; c < NUM_COLORS; c++) {
+                    problem.fixed[c] = uint8_t(view.setCount(PropertyColor(c)));
+                    if (view.isListed(PropertyColor(c))) problem.listed |= uint16_t(1u << c);
+                }
+                for (size_t j = 0; j < view.handSize(); j++) {
+                    if (wildKind(view.hand(j)) >= 0) problem.wilds[wildKind(view.hand(j))]++;
+                }
+                wilds = solveWilds(problem);
+                solved = true;
+            }
+            move.color = wilds.colorFor(wildKind(view.hand(i)));
+            rank = 5;
+        }
+        else if (info.type == CardType::PROPERTY) rank = 6;
+        else if (info.type == CardType::MONEY) rank = 2;
+        else if (info.type == CardType::RENT) {
+            if (!view.opponentHasJustSayNo() && view.rent() > 0 && view.opponentMoney() > 0) rank = 3;
+        }
+        else if (info.action == ActionKind::DEAL_BREAKER) {
+            for (int c = 0; c < NUM_COLORS && !rank; c++) {
+                if (view.opponentComplete(PropertyColor(c))) {
+                    move.color = PropertyColor(c);
+                    rank = 7;
+                }
+            }
+        }
+        else if (info.action == ActionKind::SLY_DEAL) {
+            // Prefer a property that completes one of our sets
+            int target = -1;
+            for (int c = 0; c < NUM_COLORS; c++) {
+                if (!view.opponentCount(PropertyColor(c))) continue;
+                if (target < 0) target = c;
+                if (view.setCount(PropertyColor(c)) + 1 == SET_SIZES[c]) {
+                    target = c;
+                    break;
+                }
+            }
+            if (target >= 0) {
+                move.color = PropertyColor(target);
+                rank = 4;
+            }
+        }
+        if (rank > bestRank) {
+            bestRank = rank;
+            best = move;
+        }
+    }
+    return best;
+}
+
+// greedyMove over the engine's own game state. It plays under any rules,
+// though its heuristics assume the standard set sizes; the batch
+// simulator's parity checks run it under SpeedRules too.
+template <class Rules>
+class BasicGreedyPolicy : public BasicMovePolicy<Rules> {
+private:
+    using Player = BasicPlayer<Rules>;
+    using MonopolyDealGame = BasicMonopolyDealGame<Rules>;
+
+    struct GameView {
+        const MonopolyDealGame& game;
+        const Player& self;
+        const Player& opponent;
+
+        GamePhase phase() const { return game.getPhase(); }
+        size_t handSize() const { return self.getHand().size(); }
+        CardId hand(size_t i) const { return self.getHand()[i]; }
+        int setCount(PropertyColor color) const { return int(self.getProperties().total(color)); }
+        bool isListed(PropertyColor color) const { return self.getProperties().isListed(color); }
+        bool opponentComplete(PropertyColor color) const { return opponent.isCompleteSet(color); }
+        int opponentCount(PropertyColor color) const { return int(opponent.getProperties().count(color)); }
+        int rent() const { return self.getProperties().rent(); }
+        int opponentMoney() const { return opponent.getMoney(); }
+        bool opponentHasJustSayNo() const { return opponent.hasJustSayNoCard(); }
+    };
+
+protected:
+    Move chooseMove(const MonopolyDealGame& game) override {
+        const auto& players = game.getPlayers();
+        size_t current = game.getCurrentPlayer();
+        return greedyMove(GameView{game, players[current], players[(current + 1) % players.size()]});
+    }
+};
+
+using GreedyPolicy = BasicGreedyPolicy<StandardRules>;
+
+// What WeightedPolicy scores a position by, from the mover's side
+enum HeuristicFeature {
+    MONEY_BANKED,
+    SET_PROGRESS,
+    COMPLETE_SETS,
+    NEAR_COMPLETE,
+    RENT_OWED,
+    HOLDS_JUST_SAY_NO,
+    HAND_VALUE,
+    OPPONENT_MONEY,
+    OPPONENT_PROGRESS,
+    OPPONENT_SETS,
+    END_TURN_BIAS,
+    NUM_FEATURES
+};
+
+constexpr const char* FEATURE_NAMES[NUM_FEATURES] = {
+    "money_banked", "set_progress", "complete_sets", "near_complete", "rent_owed", "holds_just_say_no",
+    "hand_value", "opponent_money", "opponent_progress", "opponent_sets", "end_turn_bias",
+};
+
+using HeuristicWeights = std::array<double, NUM_FEATURES>;
+
+// A hand-set starting point: bank some money, build sets, hurt the other
+// side's sets most of all, and play rather than pass
+constexpr HeuristicWeights DEFAULT_WEIGHTS = {0.3, 2.0, 10.0, 1.0, 0.1, 1.5, 0.05, -0.2, -1.5, -10.0, -0.5};
+
+// Features of a position for `self`. Set progress counts each incomplete
+// set by how far along it is, so the last card of a set is worth more than
+// the first.
+inline std::array<double, NUM_FEATURES> heuristicFeatures(const Player& self, const Player& opponent) {
+    std::array<double, NUM_FEATURES> features{};
+    auto progress = [](const PropertyTableau& table, int* near) {
+        double sum = 0;
+        for (int c = 0; c < NUM_COLORS; c++) {
+            PropertyColor color = PropertyColor(c);
+            if (table.isComplete(color)) continue;
+            double part = double(table.total(color)) / SET_SIZES[c];
+            sum += part * part;
+            if (near && table.total(color) + 1 == SET_SIZES[c]) (*near)++;
+        }
+        return sum;
+    };
+    int near = 0;
+    features[MONEY_BANKED] = self.getMoney();
+    features[SET_PROGRESS] = progress(self.getProperties(), &near);
+    features[COMPLETE_SETS] = self.getCompleteSetCount();
+    features[NEAR_COMPLETE] = near;
+    features[RENT_OWED] = std::min(self.getProperties().rent(), opponent.getMoney());
+    features[HOLDS_JUST_SAY_NO] = self.hasJustSayNoCard();
+    for (CardId card : self.getHand()) features[HAND_VALUE] += cardInfo(card).value;
+    features[OPPONENT_MONEY] = opponent.getMoney();
+    features[OPPONENT_PROGRESS] = progress(opponent.getProperties(), nullptr);
+    features[OPPONENT_SETS] = opponent.getCompleteSetCount();
+    return features;
+}
+
+// One-ply bot over a weighted sum of heuristicFeatures: each legal move is
+// made and unmade through Player::playCard and undoPlay on scratch copies of
+// the two players' cards and money (not their names, so nothing is ever
+// allocated), so the engine's rules are the only game logic, and the
+// best-scoring result is played. Deal Breaker, Sly Deal and Forced Deal targets are just more
+// moves to score. This is the bot the tuner (Tuner.h) optimizes.
+class WeightedPolicy : public MovePolicy {
+private:
+    HeuristicWeights weights;
+    MoveList moves;
+    Player mine{std::string(), 0};
+    Player theirs{std::string(), 1};
+    UndoRecord undo;
+
+    double score(const Player& self, const Player& opponent) const {
+        auto features = heuristicFeatures(self, opponent);
+        double sum = 0;
+        for (int f = 0; f < NUM_FEATURES; f++) sum += weights[f] * features[f];
+        return sum;
+    }
+
+protected:
+    Move chooseMove(const MonopolyDealGame& game) override {
+        const auto& players = game.getPlayers();
+        size_t current = game.getCurrentPlayer();
+        const Player& self = players[current];
+        const Player& opponent = players[(current + 1) % players.size()];
+
+        game.generateMoves(moves);
+        mine.restore(self.getHand(), self.getProperties(), self.getMoney(), self.hasJustSayNoCard());
+        theirs.restore(opponent.getHand(), opponent.getProperties(), opponent.getMoney(), opponent.hasJustSayNoCard());
+        Move best = moves[0];
+        double bestScore = -1e300;
+        for (const Move& move : moves) {
+            double value;
+            if (move.type == MoveType::PLAY) {
+                undo.move = move;
+                mine.recordPlay(move, theirs, undo);
+                if (!mine.playCard(move, theirs, nullptr)) continue;
+                value = score(mine, theirs);
+                mine.undoPlay(undo, theirs);
+            }
+            else if (move.type == MoveType::DISCARD) {
+                CardId card = mine.discard(move.handIndex);
+                value = score(mine, theirs);
+                mine.returnToHand(move.handIndex, card);
+            }
+            else {
+                value = score(mine, theirs) + weights[END_TURN_BIAS];
+            }
+            if (value > bestScore) {
+                bestScore = value;
+                best = move;
+            }
+        }
+        return best;
+    }
+
+public:
+    explicit WeightedPolicy(const HeuristicWeights& weights = DEFAULT_WEIGHTS) : weights(weights) {}
+
+    void setWeights(const HeuristicWeights& w) { weights = w; }
+    const HeuristicWeights& getWeights() const { return weights; }
+};
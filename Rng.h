@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+// SplitMix64: turns one 64-bit seed into a stream of well-mixed seeds.
+// Used to derive per-game and per-player seeds from a master seed.
+class SplitMix64 {
+private:
+    uint64_t state;
+
+public:
+    constexpr explicit SplitMix64(uint64_t seed) : state(seed) {}
+
+    static constexpr uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    constexpr uint64_t next() {
+        state += 0x9e3779b97f4a7c15ULL;
+        return mix(state);
+    }
+};
+
+// Seed for stream `index` of a master seed, e.g. game 12345 of a tournament.
+// Every game gets the same seed no matter which thread plays it.
+inline uint64_t deriveSeed(uint64_t master, uint64_t index) {
+    return SplitMix64::mix(master + SplitMix64::mix(index + 0x9e3779b97f4a7c15ULL));
+}
+
+// xoshiro256**: small, fast and statistically strong. Satisfies
+// UniformRandomBitGenerator, but the engine only uses it through below().
+class Xoshiro256 {
+private:
+    uint64_t s[4];
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256(uint64_t seed = 0) { reseed(seed); }
+
+    void reseed(uint64_t seed) {
+        SplitMix64 init(seed);
+        for (auto& word : s) word = init.next();
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Unbiased integer in [0, bound) using Lemire's multiply-and-reject
+    uint32_t below(uint32_t bound) {
+        uint64_t m = uint64_t(uint32_t((*this)() >> 32)) * bound;
+        uint32_t low = uint32_t(m);
+        if (low < bound) {
+            uint32_t threshold = uint32_t(-bound) % bound;
+            while (low < threshold) {
+                m = uint64_t(uint32_t((*this)() >> 32)) * bound;
+                low = uint32_t(m);
+            }
+        }
+        return uint32_t(m >> 32);
+    }
+
+    // The raw state, for snapshots
+    uint64_t word(int i) const { return s[i]; }
+    void setState(uint64_t s0, uint64_t s1, uint64_t s2, uint64_t s3) {
+        s[0] = s0;
+        s[1] = s1;
+        s[2] = s2;
+        s[3] = s3;
+    }
+
+    bool operator==(const Xoshiro256& other) const {
+        return s[0] == other.s[0] && s[1] == other.s[1] && s[2] == other.s[2] && s[3] == other.s[3];
+    }
+};
+
+// Fisher-Yates with our own bounded draws, so a seed deals the same deck on
+// every standard library (std::shuffle's exact sequence is unspecified).
+template <class Pile>
+void shuffleCards(Pile& pile, Xoshiro256& rng) {
+    for (size_t i = pile.size(); i > 1; i--) {
+        size_t j = rng.below(uint32_t(i));
+        auto tmp = pile[i - 1];
+        pile[i - 1] = pile[j];
+        pile[j] = tmp;
+    }
+}
+
+// One step of shuffleCards, taken only when a card is needed: swaps a
+// uniformly chosen card to the top (the end) and returns where it came
+// from. Drawing a whole pile this way deals the order shuffleCards would
+// have, with the same draws from rng, but a pile that is never fully
+// drawn costs only the cards taken from it.
+template <class Pile>
+size_t shuffleTop(Pile& pile, Xoshiro256& rng) {
+    size_t top = pile.size() - 1;
+    if (pile.size() < 2) return top;
+    size_t j = rng.below(uint32_t(pile.size()));
+    auto tmp = pile[top];
+    pile[top] = pile[j];
+    pile[j] = tmp;
+    return j;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include "Cards.h"
+
+// The constants of a rule set. The engine is a template over one of these
+// (see BasicMonopolyDealGame), so each variant compiles to its own engine
+// with its limits folded in as constants. A rules type provides:
+//   SET_SIZES       cards for a complete set of each color (rent is twice that)
+//   SETS_TO_WIN     complete sets that win the game
+//   PLAYS_PER_TURN  cards a player may play each turn
+//   HAND_LIMIT      cards kept at the end of a turn
+//   STARTING_CARDS  cards dealt to each player
+//   DRAWS_PER_TURN  cards drawn at the start of each turn
+//   MIN_PLAYERS, MAX_PLAYERS  seats at one table
+//   inDeck(id)      whether a card of the catalog is in the deck
+struct StandardRules {
+    static constexpr std::array<uint8_t, NUM_COLORS> SET_SIZES = ::SET_SIZES;
+    static constexpr int SETS_TO_WIN = 3;
+    static constexpr int PLAYS_PER_TURN = 3;
+    static constexpr int HAND_LIMIT = 7;
+    static constexpr int STARTING_CARDS = 5;
+    static constexpr int DRAWS_PER_TURN = 2;
+    static constexpr int MIN_PLAYERS = 2;
+    static constexpr int MAX_PLAYERS = ::MAX_PLAYERS;
+
+    static constexpr bool inDeck(CardId) { return true; }
+};
+
+// A common house variant for quicker games: four plays and three draws a
+// turn, an 8-card hand, three-card railroad sets and no Forced Deals
+struct SpeedRules : StandardRules {
+    static constexpr std::array<uint8_t, NUM_COLORS> SET_SIZES = {2, 3, 3, 3, 3, 3, 3, 2, 2, 3};
+    static constexpr int PLAYS_PER_TURN = 4;
+    static constexpr int HAND_LIMIT = 8;
+    static constexpr int DRAWS_PER_TURN = 3;
+
+    static constexpr bool inDeck(CardId id) { return CARD_CATALOG[id].action != ActionKind::FORCED_DEAL; }
+};
+
+// Standard rules for up to six players. One deck still covers the deal:
+// six hands of five take 30 of its 172 cards.
+struct BigTableRules : StandardRules {
+    static constexpr int MAX_PLAYERS = MAX_SEATS;
+};
+
+// The most cards a hand can hold while playing: the deal or the hand limit,
+// with a turn's draws on top
+template <class Rules>
+constexpr int maxHandSize() {
+    return std::max(Rules::STARTING_CARDS, Rules::HAND_LIMIT) + Rules::DRAWS_PER_TURN;
+}
+
+// The largest hand of any rule set above; MoveList is sized from it, and the
+// engine refuses a rules type whose hands could grow past it
+constexpr int MAX_HAND_CARDS =
+    std::max({maxHandSize<StandardRules>(), maxHandSize<SpeedRules>(), maxHandSize<BigTableRules>()});
+
+// Checks every rules type used to instantiate the engine
+template <class Rules>
+constexpr bool validRules() {
+    int deck = 0;
+    for (int id = 0; id < NUM_CARDS; id++) deck += Rules::inDeck(CardId(id));
+    for (int c = 0; c < NUM_COLORS; c++) {
+        if (Rules::SET_SIZES[c] < 1 || Rules::SET_SIZES[c] > MAX_COLOR_CARDS + NUM_WILDS) return false;
+    }
+    return Rules::MIN_PLAYERS >= 2 && Rules::MAX_PLAYERS <= MAX_SEATS && Rules::MIN_PLAYERS <= Rules::MAX_PLAYERS &&
+           Rules::SETS_TO_WIN >= 1 && Rules::PLAYS_PER_TURN >= 1 && Rules::PLAYS_PER_TURN < 8 &&
+           Rules::HAND_LIMIT >= 1 && Rules::DRAWS_PER_TURN >= 1 &&
+           Rules::STARTING_CARDS * Rules::MAX_PLAYERS <= deck;
+}
@@ -0,0 +1,37 @@
+#include <iostream>
+#include <csignal>
+#include <cstring>
+#include "Server.h"
+
+using namespace std;
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void requestStop(int) { stopRequested = 1; }
+
+// Hosts many tables at once over the line protocol in Server.h
+int main(int argc, char** argv) {
+    string endpoint = "tcp:127.0.0.1:7777";
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--listen") && i + 1 < argc) endpoint = argv[++i];
+        else {
+            cerr << "usage: " << argv[0] << " [--listen tcp:[HOST:]PORT | unix:PATH]\n";
+            return 1;
+        }
+    }
+
+    signal(SIGINT, requestStop);
+    signal(SIGTERM, requestStop);
+    signal(SIGPIPE, SIG_IGN);
+
+    GameServer server;
+    if (!server.listen(endpoint)) {
+        cerr << "cannot listen on " << endpoint << ": " << strerror(errno) << "\n";
+        return 1;
+    }
+    cout << "listening on " << endpoint << endl;
+    server.run(stopRequested);
+    cout << "sessions:     " << server.getSessionsStarted() << "\n";
+    cout << "moves:        " << server.getMovesPlayed() << "\n";
+    return 0;
+}
@@ -0,0 +1,428 @@
+#pragma once
+
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "MonopolyDeal.h"
+#include "Moves.h"
+#include "Rng.h"
+
+// Line protocol spoken by monopoly_server. Every line ends in '\n'.
+//
+//   client                      server
+//   NEW <seed> [players]   ->   STATE ... and MOVES ..., or OVER ...
+//   MOVE <move>            ->   the same, once the bots have moved
+//   QUIT                   ->   (closes the connection)
+//                               ERR <reason> for anything it cannot do
+//
+//   STATE <turn> <play|discard> <money> <my sets> <their sets> <hand ids, comma separated>
+//   MOVES <move> <move> ...     every legal move, in generateMoves order
+//   OVER <winner seat or -1> <turns>
+//
+// Moves are written "e" (end turn), "d<i>" (discard hand card i) or
+// "p<i>[.<color>[.<take>]]" (play hand card i, with PropertyColor numbers
+// for its targets). The client always sits in seat 0; the other seats are
+// random bots run by the server.
+namespace protocol {
+
+inline void appendMove(std::string& out, const Move& move) {
+    if (move.type == MoveType::END_TURN) {
+        out += 'e';
+        return;
+    }
+    out += move.type == MoveType::DISCARD ? 'd' : 'p';
+    out += std::to_string(move.handIndex);
+    if (move.color != PropertyColor::NONE || move.take != PropertyColor::NONE) {
+        out += '.';
+        out += std::to_string(int(move.color));
+    }
+    if (move.take != PropertyColor::NONE) {
+        out += '.';
+        out += std::to_string(int(move.take));
+    }
+}
+
+// Reads a move written by appendMove. It still has to be legal.
+inline bool parseMove(const char* text, Move& move) {
+    if (text[0] == 'e' && text[1] == '\0') {
+        move = Move::endTurn();
+        return true;
+    }
+    if (text[0] != 'p' && text[0] != 'd') return false;
+    int fields[3] = {0, int(PropertyColor::NONE), int(PropertyColor::NONE)};
+    const char* pos = text + 1;
+    for (int f = 0; f < 3; f++) {
+        char* end;
+        long value = strtol(pos, &end, 10);
+        if (end == pos || value < 0 || value > 255) return false;
+        fields[f] = int(value);
+        pos = end;
+        if (*pos == '\0') break;
+        if (*pos != '.' || f == 2) return false;
+        pos++;
+    }
+    if (fields[1] > int(PropertyColor::NONE) || fields[2] > int(PropertyColor::NONE)) return false;
+    if (text[0] == 'd') {
+        if (fields[1] != int(PropertyColor::NONE)) return false;
+        move = Move::discard(size_t(fields[0]));
+    } else {
+        move = Move::play(size_t(fields[0]), PropertyColor(fields[1]), PropertyColor(fields[2]));
+    }
+    return true;
+}
+
+}  // namespace protocol
+
+// One table. The game is driven move by move instead of through playGame,
+// so a session just sits between two inputs and never blocks a thread.
+class Session {
+private:
+    MonopolyDealGame game;
+    Xoshiro256 botRng;
+    MoveList moves;
+
+    // Plays the bots' turns until seat 0 must decide or the game ends
+    void advance() {
+        while (!game.isOver() && game.getCurrentPlayer() != 0) {
+            game.generateMoves(moves);
+            game.applyMove(moves[botRng.below(uint32_t(moves.size()))]);
+        }
+    }
+
+public:
+    static constexpr int MAX_TURNS = 1000;
+
+    Session(const std::vector<std::string>& names, uint64_t seed) : game(names, seed), botRng(deriveSeed(seed, 1)) {
+        game.setMaxTurns(MAX_TURNS);
+        game.start();
+        advance();
+    }
+
+    bool isOver() const { return game.isOver(); }
+
+    // False, changing nothing, if the move is not legal right now
+    bool play(const Move& move) {
+        if (game.isOver() || !game.applyMove(move)) return false;
+        advance();
+        return true;
+    }
+
+    // Appends what the client needs for its next decision, or the result
+    void describe(std::string& out) {
+        if (game.isOver()) {
+            out += "OVER " + std::to_string(game.getWinner()) + " " + std::to_string(game.getTurnCount()) + "\n";
+            return;
+        }
+        const Player& self = game.getPlayers()[0];
+        const Player& next = game.getPlayers()[1];
+        out += "STATE " + std::to_string(game.getTurnCount());
+        out += game.getPhase() == GamePhase::DISCARD ? " discard " : " play ";
+        out += std::to_string(self.getMoney()) + " " + std::to_string(self.getCompleteSetCount()) + " " +
+               std::to_string(next.getCompleteSetCount()) + " ";
+        for (size_t i = 0; i < self.getHand().size(); i++) {
+            if (i) out += ',';
+            out += std::to_string(self.getHand()[i]);
+        }
+        out += "\nMOVES";
+        game.generateMoves(moves);
+        for (const Move& move : moves) {
+            out += ' ';
+            protocol::appendMove(out, move);
+        }
+        out += '\n';
+    }
+};
+
+// Where a server listens or a client connects: "tcp:PORT", "tcp:HOST:PORT"
+// or "unix:PATH". Returns a socket fd, or -1 with errno set.
+inline int openEndpoint(const std::string& endpoint, bool listening) {
+    int fd = -1;
+    if (endpoint.rfind("unix:", 0) == 0) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::string path = endpoint.substr(5);
+        if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+            errno = EINVAL;
+            return -1;
+        }
+        memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        if (listening) unlink(addr.sun_path);
+        int rc = listening ? bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr))
+                           : connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        if (rc != 0 || (listening && listen(fd, SOMAXCONN) != 0)) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+    if (endpoint.rfind("tcp:", 0) == 0) {
+        std::string rest = endpoint.substr(4);
+        std::string host = "127.0.0.1";
+        size_t colon = rest.rfind(':');
+        if (colon != std::string::npos) {
+            host = rest.substr(0, colon);
+            rest = rest.substr(colon + 1);
+        }
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(uint16_t(atoi(rest.c_str())));
+        if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+            errno = EINVAL;
+            return -1;
+        }
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        if (listening) setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        int rc = listening ? bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr))
+                           : connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        if (rc != 0 || (listening && listen(fd, SOMAXCONN) != 0)) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+    errno = EINVAL;
+    return -1;
+}
+
+inline void setNonBlocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+// Serves any number of tables from one thread with a level-triggered epoll
+// loop. Each connection owns at most one Session at a time.
+class GameServer {
+private:
+    struct Connection {
+        explicit Connection(int fd) : fd(fd) {}
+
+        int fd;
+        std::string input;
+        std::string output;
+        size_t sent = 0;
+        bool writing = false;
+        bool closing = false;
+        std::optional<Session> session;
+    };
+
+    // Longest line a client may send
+    static constexpr size_t MAX_LINE = 4096;
+
+    int listener = -1;
+    // Out of file descriptors: the listener is left out of the epoll set,
+    // which would otherwise report it ready forever, until one is freed
+    bool acceptPaused = false;
+    int epoll = -1;
+    std::vector<std::unique_ptr<Connection>> connections;   // indexed by fd
+    std::vector<std::string> names;
+    uint64_t sessionsStarted = 0;
+    uint64_t movesPlayed = 0;
+
+    // Asks for EPOLLOUT only while a reply is stuck in the socket buffer
+    void watch(Connection& c) {
+        bool writing = c.sent < c.output.size();
+        if (writing == c.writing) return;
+        c.writing = writing;
+        epoll_event event{};
+        event.events = writing ? EPOLLIN | EPOLLOUT : EPOLLIN;
+        event.data.fd = c.fd;
+        epoll_ctl(epoll, EPOLL_CTL_MOD, c.fd, &event);
+    }
+
+    bool watchListener() {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = listener;
+        return epoll_ctl(epoll, EPOLL_CTL_ADD, listener, &event) == 0;
+    }
+
+    void resumeAccepting() {
+        if (!acceptPaused) return;
+        acceptPaused = false;
+        watchListener();
+    }
+
+    void accept() {
+        while (true) {
+            int fd = ::accept(listener, nullptr, nullptr);
+            if (fd < 0) {
+                if (errno == EMFILE || errno == ENFILE) {
+                    acceptPaused = true;
+                    epoll_ctl(epoll, EPOLL_CTL_DEL, listener, nullptr);
+                }
+                return;
+            }
+            setNonBlocking(fd);
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            if (size_t(fd) >= connections.size()) connections.resize(fd + 1);
+            connections[fd].reset(new Connection(fd));
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.fd = fd;
+            epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event);
+        }
+    }
+
+    void drop(int fd) {
+        epoll_ctl(epoll, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        connections[fd].reset();
+        resumeAccepting();
+    }
+
+    void handleLine(Connection& c, char* line) {
+        char* args = strchr(line, ' ');
+        if (args) *args++ = '\0';
+        else args = line + strlen(line);
+
+        if (!strcmp(line, "NEW")) {
+            // Nothing but the numbers: "NEW 2abc" is refused
+            char* end;
+            uint64_t seed = strtoull(args, &end, 10);
+            bool valid = end != args && (*end == '\0' || *end == ' ');
+            long players = 2;
+            if (valid && *end) {
+                char* start = end + 1;
+                players = strtol(start, &end, 10);
+                valid = end != start && *end == '\0';
+            }
+            if (!valid || players < 2 || players > MAX_PLAYERS) {
+                c.output += "ERR usage: NEW <seed> [players 2-4]\n";
+                return;
+            }
+            c.session.emplace(std::vector<std::string>(names.begin(), names.begin() + players), seed);
+            sessionsStarted++;
+            c.session->describe(c.output);
+        }
+        else if (!strcmp(line, "MOVE")) {
+            Move move;
+            if (!c.session) c.output += "ERR no game\n";
+            else if (!protocol::parseMove(args, move)) c.output += "ERR bad move\n";
+            else if (!c.session->play(move)) c.output += "ERR illegal move\n";
+            else {
+                movesPlayed++;
+                c.session->describe(c.output);
+            }
+        }
+        else if (!strcmp(line, "QUIT")) c.closing = true;
+        else c.output += "ERR unknown command\n";
+    }
+
+    // Handles every complete line received so far, up to a QUIT
+    void handleLines(Connection& c) {
+        size_t start = 0;
+        for (size_t newline; !c.closing && (newline = c.input.find('\n', start)) != std::string::npos; start = newline + 1) {
+            c.input[newline] = '\0';
+            if (newline > start && c.input[newline - 1] == '\r') c.input[newline - 1] = '\0';
+            handleLine(c, &c.input[start]);
+        }
+        c.input.erase(0, start);
+        if (!c.closing && c.input.size() > MAX_LINE) {
+            c.output += "ERR line too long\n";
+            c.closing = true;
+        }
+    }
+
+    // Lines are handled after every read, so what is buffered never
+    // exceeds one unfinished line of MAX_LINE plus one read
+    void receive(Connection& c) {
+        char buffer[4096];
+        while (!c.closing) {
+            ssize_t n = read(c.fd, buffer, sizeof(buffer));
+            if (n > 0) {
+                c.input.append(buffer, size_t(n));
+                handleLines(c);
+                continue;
+            }
+            if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) c.closing = true;
+            break;
+        }
+    }
+
+    void send(Connection& c) {
+        while (c.sent < c.output.size()) {
+            ssize_t n = write(c.fd, c.output.data() + c.sent, c.output.size() - c.sent);
+            if (n <= 0) {
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+                c.closing = true;
+                c.output.clear();
+                c.sent = 0;
+                return;
+            }
+            c.sent += size_t(n);
+        }
+        c.output.clear();
+        c.sent = 0;
+    }
+
+public:
+    GameServer() {
+        for (int i = 0; i < MAX_PLAYERS; i++) names.push_back("P" + std::to_string(i + 1));
+    }
+    ~GameServer() {
+        for (auto& c : connections) {
+            if (c) close(c->fd);
+        }
+        if (listener >= 0) close(listener);
+        if (epoll >= 0) close(epoll);
+    }
+
+    GameServer(const GameServer&) = delete;
+    GameServer& operator=(const GameServer&) = delete;
+
+    // Starts listening; false with errno set on failure
+    bool listen(const std::string& endpoint) {
+        listener = openEndpoint(endpoint, true);
+        if (listener < 0) return false;
+        setNonBlocking(listener);
+        epoll = epoll_create1(0);
+        if (epoll < 0) return false;
+        return watchListener();
+    }
+
+    // Serves until `stop` becomes nonzero (e.g. from a signal handler)
+    void run(const volatile std::sig_atomic_t& stop) {
+        epoll_event events[256];
+        while (!stop) {
+            int ready = epoll_wait(epoll, events, 256, 200);
+            // A quiet interval is the back-off for a paused listener, in
+            // case the descriptors were freed outside the server
+            if (ready == 0) resumeAccepting();
+            for (int i = 0; i < ready; i++) {
+                int fd = events[i].data.fd;
+                if (fd == listener) {
+                    accept();
+                    continue;
+                }
+                Connection* c = size_t(fd) < connections.size() ? connections[fd].get() : nullptr;
+                if (!c) continue;
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) receive(*c);
+                send(*c);
+                if (c->closing && c->output.empty()) drop(fd);
+                else watch(*c);
+            }
+        }
+    }
+
+    uint64_t getSessionsStarted() const { return sessionsStarted; }
+    uint64_t getMovesPlayed() const { return movesPlayed; }
+};
@@ -0,0 +1,223 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include "Tournament.h"
+#include "Tuner.h"
+
+using namespace std;
+
+static void usage(const char* program) {
+    cerr << "usage: " << program << " [--games N] [--players 2-4] [--max-turns N] [--seed S] [--threads T] [--log FILE]\n";
+    cerr << "       " << program << " ... [--metrics FILE.json] [--prometheus FILE] [--trace FILE.json]\n";
+    cerr << "       " << program << " ... --checkpoint FILE [--checkpoint-every N]\n";
+    cerr << "       " << program << " --replay FILE\n";
+    cerr << "       " << program << " --tune GENERATIONS [--population N] [--deals N] [--checkpoint FILE] [--seed S] [--threads T]\n";
+}
+
+// Replays every game in a log through the engine and checks each one ends as recorded
+static int replayLog(const char* path) {
+    MappedGameLog log;
+    if (!log.open(path)) {
+        cerr << "cannot read game log " << path << "\n";
+        return 1;
+    }
+
+    auto start = chrono::steady_clock::now();
+    GameLogRecord record;
+    uint64_t games = 0, events = 0, failures = 0;
+    while (log.next(record)) {
+        ReplayResult result = replayGame(record);
+        if (!result.ok && failures++ < 10) cerr << "game " << games << ": " << result.error << "\n";
+        events += result.events;
+        games++;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (log.isCorrupt()) {
+        cerr << "log is truncated after game " << games << "\n";
+        failures++;
+    }
+
+    cout << "games:        " << games << "\n";
+    cout << "bytes/game:   " << double(log.size()) / max<uint64_t>(games, 1) << "\n";
+    cout << "events:       " << events << "\n";
+    cout << "seconds:      " << seconds << "\n";
+    cout << "games/sec:    " << games / seconds << "\n";
+    cout << "failed:       " << failures << "\n";
+    return failures ? 1 : 0;
+}
+
+// Tunes WeightedPolicy against GreedyPolicy, saving after every generation
+// when there is a checkpoint file and resuming from it if it exists
+static int runTuning(const TunerConfig& config, int generations, const char* checkpointPath) {
+    HeuristicTuner tuner(config);
+    if (checkpointPath && ifstream(checkpointPath)) {
+        if (!tuner.resume(checkpointPath)) {
+            cerr << "cannot resume from " << checkpointPath << " (unreadable, or another seed, population or deal count)\n";
+            return 1;
+        }
+        cout << "resumed at generation " << tuner.state().generation << "\n";
+    }
+
+    cout << "generation   best    mean   sigma\n";
+    auto start = chrono::steady_clock::now();
+    int ran = 0;
+    uint64_t gamesBefore = tuner.state().games;
+    while (tuner.state().generation < generations) {
+        GenerationResult result = tuner.step();
+        ran++;
+        cout << setw(10) << tuner.state().generation << fixed << setprecision(3) << setw(7) << result.bestFitness
+             << setw(8) << result.meanFitness << setw(8) << tuner.state().sigma << "\n" << defaultfloat;
+        if (checkpointPath && !tuner.save(checkpointPath)) {
+            cerr << "writing the checkpoint failed\n";
+            return 1;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "seconds:      " << seconds << "\n";
+    if (ran) {
+        cout << fixed << setprecision(0) << "gens/hour:    " << ran * 3600 / seconds << "\n";
+        cout << "games/sec:    " << (tuner.state().games - gamesBefore) / seconds << "\n" << defaultfloat << setprecision(4);
+    }
+    cout << "weights:\n";
+    for (int f = 0; f < NUM_FEATURES; f++) {
+        cout << "  " << left << setw(20) << FEATURE_NAMES[f] << right << tuner.state().mean[f] << "\n";
+    }
+    return 0;
+}
+
+// Plays the tournament in pieces of `every` games, saving the totals after
+// each one and picking up from the checkpoint file if it exists. The totals
+// and the digest come out as they would in a single run.
+static TournamentResult runCheckpointed(TournamentConfig config, uint64_t every, const char* checkpointPath, uint64_t& resumed,
+                                        bool& ok) {
+    uint64_t total = config.games;
+    TournamentResult result(config.players);
+    ok = true;
+    if (ifstream(checkpointPath)) {
+        if (!resumeTournament(checkpointPath, config, result) || result.games > total) {
+            cerr << "cannot resume from " << checkpointPath << " (unreadable, or another seed, table size or turn limit)\n";
+            ok = false;
+            return result;
+        }
+        resumed = result.games;
+        cout << "resumed after " << resumed << " games\n";
+    }
+    while (result.games < total) {
+        config.firstGame = result.games;
+        config.games = min(every, total - result.games);
+        result.merge(runTournament(config));
+        if (!saveTournament(checkpointPath, config, result)) {
+            cerr << "writing the checkpoint failed\n";
+            ok = false;
+            return result;
+        }
+    }
+    return result;
+}
+
+// Plays a tournament of headless games between random policies and reports throughput
+int main(int argc, char** argv) {
+    TournamentConfig config;
+    const char* logPath = nullptr;
+    const char* metricsPath = nullptr;
+    const char* prometheusPath = nullptr;
+    const char* tracePath = nullptr;
+    TunerConfig tuning;
+    int generations = 0;
+    const char* checkpointPath = nullptr;
+    uint64_t checkpointEvery = 100000;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) { usage(argv[0]); return 1; }
+        const char* value = argv[++i];
+        if (!strcmp(argv[i - 1], "--games")) config.games = strtoull(value, nullptr, 10);
+        else if (!strcmp(argv[i - 1], "--players")) config.players = atoi(value);
+        else if (!strcmp(argv[i - 1], "--max-turns")) config.maxTurns = atoi(value);
+        else if (!strcmp(argv[i - 1], "--seed")) config.masterSeed = strtoull(value, nullptr, 10);
+        else if (!strcmp(argv[i - 1], "--threads")) config.threads = atoi(value);
+        else if (!strcmp(argv[i - 1], "--log")) logPath = value;
+        else if (!strcmp(argv[i - 1], "--replay")) return replayLog(value);
+        else if (!strcmp(argv[i - 1], "--metrics")) metricsPath = value;
+        else if (!strcmp(argv[i - 1], "--prometheus")) prometheusPath = value;
+        else if (!strcmp(argv[i - 1], "--trace")) tracePath = value;
+        else if (!strcmp(argv[i - 1], "--tune")) generations = atoi(value);
+        else if (!strcmp(argv[i - 1], "--population")) tuning.population = atoi(value);
+        else if (!strcmp(argv[i - 1], "--deals")) tuning.deals = atoi(value);
+        else if (!strcmp(argv[i - 1], "--checkpoint")) checkpointPath = value;
+        else if (!strcmp(argv[i - 1], "--checkpoint-every")) checkpointEvery = strtoull(value, nullptr, 10);
+        else { usage(argv[0]); return 1; }
+    }
+
+    if (generations > 0) {
+        if (tuning.population < 4 || tuning.deals < 1) {
+            usage(argv[0]);
+            return 1;
+        }
+        tuning.masterSeed = config.masterSeed;
+        tuning.threads = config.threads;
+        tuning.maxTurns = config.maxTurns;
+        return runTuning(tuning, generations, checkpointPath);
+    }
+
+    if (config.games < 1 || config.players < 2 || config.players > 4 || config.maxTurns < 1 || checkpointEvery < 1) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if ((metricsPath || prometheusPath || tracePath) && !metrics::ENABLED) {
+        cerr << "warning: built without MONOPOLY_METRICS, phase timings will be empty\n";
+    }
+    if (tracePath) metrics::enableTrace();
+
+    if (checkpointPath && logPath) {
+        cerr << "--log needs the whole tournament in one run, so it cannot be combined with --checkpoint\n";
+        return 1;
+    }
+
+    GameLogWriter log;
+    if (logPath) {
+        if (!log.open(logPath)) {
+            cerr << "cannot write game log " << logPath << "\n";
+            return 1;
+        }
+        config.log = &log;
+    }
+
+    auto start = chrono::steady_clock::now();
+    bool ok = true;
+    uint64_t resumed = 0;
+    TournamentResult result =
+        checkpointPath ? runCheckpointed(config, checkpointEvery, checkpointPath, resumed, ok) : runTournament(config);
+    if (!ok) return 1;
+    if (logPath && !log.close()) {
+        cerr << "writing the game log failed\n";
+        return 1;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "games:        " << result.games << "\n";
+    cout << "seed:         " << config.masterSeed << "\n";
+    cout << "seconds:      " << seconds << "\n";
+    cout << "games/sec:    " << (result.games - resumed) / seconds << "\n";
+    cout << "avg turns:    " << double(result.turns) / result.games << "\n";
+    for (int i = 0; i < config.players; i++) {
+        cout << "P" << i + 1 << " wins:      " << result.wins[i] << "\n";
+    }
+    cout << "unfinished:   " << result.unfinished << "\n";
+    cout << "digest:       " << hex << result.digest << dec << "\n";
+    if (logPath) cout << "log bytes:    " << log.bytesWritten() << "\n";
+
+    if ((metricsPath && !metrics::writeJson(metricsPath)) || (prometheusPath && !metrics::writePrometheus(prometheusPath)) ||
+        (tracePath && !metrics::writeTrace(tracePath))) {
+        cerr << "could not write the metrics\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "MonopolyDeal.h"
+
+// Binary snapshot of a whole position, for saving a game to analyze later
+// and for checkpoints. All integers are little-endian:
+//
+//   4 bytes  magic "MDS1"
+//   u8       player count
+//   u8       current player, u8 phase, u8 plays this turn, u8 winner + 1
+//   u32      turn count, u32 turn limit (0 = none)
+//   u64      seed, then the four u64 words of the RNG
+//   per player:
+//     u8 money, u8 holds Just Say No, u8 hand size, hand card ids
+//     u16 colors with an entry on the table
+//     per color: u8 real cards, their ids in the order played
+//     u8 wilds, then (id, color) for each in the order played
+//   u8 draw pile size, ids bottom to top; the same for the discard pile
+//   u64      check: the position hash mixed with the fields it leaves out
+//            (seed, turns, RNG), verified before anything is restored
+//
+// Every card of the deck is written at most once, so a snapshot never
+// exceeds MAX_SNAPSHOT_BYTES; two players take about 250 bytes. Neither
+// writing nor reading allocates, and restoring into a game with the same
+// number of players leaves it exactly as the snapshot's source was (see
+// MonopolyDealGame::sameState), RNG included, so play continues
+// identically.
+//
+// A batch file (saveSnapshots) is the magic "MDB1", a u32 game count and
+// then each game's snapshot after its u16 length.
+namespace snapshot {
+
+constexpr char MAGIC[4] = {'M', 'D', 'S', '1'};
+constexpr char BATCH_MAGIC[4] = {'M', 'D', 'B', '1'};
+
+} // namespace snapshot
+
+constexpr size_t MAX_SNAPSHOT_BYTES = 64 + MAX_SEATS * (8 + NUM_COLORS) + 2 * NUM_CARDS;
+
+static_assert(MAX_MONEY < 256, "money is saved in one byte");
+
+namespace detail {
+
+struct SnapshotWriter {
+    uint8_t* pos;
+
+    void u8(uint64_t value) { *pos++ = uint8_t(value); }
+    void u16(uint64_t value) {
+        u8(value);
+        u8(value >> 8);
+    }
+    void u32(uint64_t value) {
+        u16(value);
+        u16(value >> 16);
+    }
+    void u64(uint64_t value) {
+        u32(value);
+        u32(value >> 32);
+    }
+    void pile(const CardPile& cards) {
+        u8(cards.size());
+        for (CardId card : cards) u8(card);
+    }
+};
+
+// Reads fail (and keep failing) once past the end, so callers check once
+struct SnapshotReader {
+    const uint8_t* pos;
+    const uint8_t* end;
+    bool ok = true;
+
+    uint64_t u8() {
+        if (pos >= end) {
+            ok = false;
+            return 0;
+        }
+        return *pos++;
+    }
+    uint64_t u16() { uint64_t low = u8(); return low | u8() << 8; }
+    uint64_t u32() { uint64_t low = u16(); return low | u16() << 16; }
+    uint64_t u64() { uint64_t low = u32(); return low | u32() << 32; }
+
+    // Card ids are checked against the catalog and against every card read
+    // so far, so a corrupt snapshot cannot hold a card twice
+    CardId card(uint64_t (&seen)[(NUM_CARDS + 63) / 64]) {
+        uint64_t id = u8();
+        if (id >= NUM_CARDS || (seen[id / 64] >> (id % 64) & 1)) {
+            ok = false;
+            return 0;
+        }
+        seen[id / 64] |= 1ULL << (id % 64);
+        return CardId(id);
+    }
+    bool pile(CardPile& cards, uint64_t (&seen)[(NUM_CARDS + 63) / 64]) {
+        cards.clear();
+        uint64_t size = u8();
+        for (uint64_t i = 0; i < size && ok; i++) cards.push_back(card(seen));
+        return ok;
+    }
+};
+
+// The position hash covers the cards, money and turn phase; the rest of
+// the header is mixed in so that damage to it is caught too
+inline uint64_t snapshotCheck(uint64_t positionHash, uint64_t seed, uint64_t turns, uint64_t maxTurns,
+                              const uint64_t (&words)[4]) {
+    uint64_t check = deriveSeed(seed, turns << 32 | maxTurns);
+    for (uint64_t word : words) check = deriveSeed(check, word);
+    return positionHash ^ check;
+}
+
+} // namespace detail
+
+// Writes `game` to `out`, which must have room for MAX_SNAPSHOT_BYTES.
+// Returns the bytes written.
+template <class Rules>
+size_t writeSnapshot(const BasicMonopolyDealGame<Rules>& game, uint8_t* out) {
+    detail::SnapshotWriter w{out};
+    for (char c : snapshot::MAGIC) w.u8(uint8_t(c));
+    const auto& players = game.getPlayers();
+    w.u8(players.size());
+    w.u8(game.getCurrentPlayer());
+    w.u8(uint8_t(game.getPhase()));
+    w.u8(game.getPlaysThisTurn());
+    w.u8(game.getWinner() + 1);
+    w.u32(uint32_t(game.getTurnCount()));
+    w.u32(uint32_t(game.getMaxTurns()));
+    w.u64(game.getSeed());
+    uint64_t words[4];
+    for (int i = 0; i < 4; i++) w.u64(words[i] = game.getRng().word(i));
+
+    for (const auto& player : players) {
+        w.u8(player.getMoney());
+        w.u8(player.hasJustSayNoCard());
+        w.pile(player.getHand());
+        const auto& table = player.getProperties();
+        w.u16(table.listedMask());
+        for (int c = 0; c < NUM_COLORS; c++) {
+            PropertyColor color = PropertyColor(c);
+            w.u8(table.count(color));
+            for (size_t i = 0; i < table.count(color); i++) w.u8(table.card(color, i));
+        }
+        w.u8(table.wildTotal());
+        for (size_t i = 0; i < table.wildTotal(); i++) {
+            w.u8(table.wild(i).id);
+            w.u8(uint8_t(table.wild(i).color));
+        }
+    }
+    w.pile(game.getDrawPile());
+    w.pile(game.getDiscardPile());
+    w.u64(detail::snapshotCheck(game.hash(), game.getSeed(), uint32_t(game.getTurnCount()), uint32_t(game.getMaxTurns()), words));
+    return size_t(w.pos - out);
+}
+
+// Restores a snapshot into `game`, which must have the same number of
+// players. Everything is read and checked before the game is touched, so a
+// snapshot that is truncated, corrupt or from another table size returns
+// false and leaves the game as it was.
+template <class Rules>
+bool readSnapshot(BasicMonopolyDealGame<Rules>& game, const uint8_t* data, size_t size) {
+    using PropertyTableau = BasicPropertyTableau<Rules>;
+    detail::SnapshotReader r{data, data + size};
+    for (char c : snapshot::MAGIC) {
+        if (r.u8() != uint8_t(c)) return false;
+    }
+    size_t count = r.u8();
+    if (!r.ok || count != game.getPlayers().size()) return false;
+    size_t current = r.u8();
+    uint64_t phase = r.u8();
+    int plays = int(r.u8());
+    int winner = int(r.u8()) - 1;
+    uint64_t turns = r.u32();
+    uint64_t maxTurns = r.u32();
+    uint64_t seed = r.u64();
+    uint64_t words[4];
+    for (auto& word : words) word = r.u64();
+    if (!r.ok || current >= count || phase > uint64_t(GamePhase::OVER) || plays > Rules::PLAYS_PER_TURN ||
+        winner >= int(count) || (words[0] | words[1] | words[2] | words[3]) == 0) return false;
+
+    uint64_t seen[(NUM_CARDS + 63) / 64] = {};
+    CardPile hands[MAX_SEATS];
+    PropertyTableau tables[MAX_SEATS];
+    int money[MAX_SEATS];
+    bool justSayNo[MAX_SEATS];
+    for (size_t p = 0; p < count; p++) {
+        money[p] = int(r.u8());
+        justSayNo[p] = r.u8() != 0;
+        if (!r.pile(hands[p], seen)) return false;
+
+        tables[p] = PropertyTableau(int(p));
+        uint16_t listed = uint16_t(r.u16());
+        for (int c = 0; c < NUM_COLORS; c++) {
+            uint64_t real = r.u8();
+            if (real > MAX_COLOR_CARDS) return false;
+            for (uint64_t i = 0; i < real && r.ok; i++) {
+                CardId card = r.card(seen);
+                if (!r.ok || cardInfo(card).color != PropertyColor(c) || cardInfo(card).isWild) return false;
+                tables[p].add(card, PropertyColor(c));
+            }
+        }
+        uint64_t wilds = r.u8();
+        if (wilds > NUM_WILDS) return false;
+        for (uint64_t i = 0; i < wilds && r.ok; i++) {
+            CardId card = r.card(seen);
+            PropertyColor color = PropertyColor(r.u8());
+            if (!r.ok || !cardInfo(card).isWild || !wildAllows(card, color)) return false;
+            tables[p].addWild(card, color);
+        }
+        if (!r.ok || listed >> NUM_COLORS) return false;
+        tables[p].restoreListed(listed);
+    }
+    CardPile draw, discard;
+    if (!r.pile(draw, seen) || !r.pile(discard, seen)) return false;
+    uint64_t check = r.u64();
+    if (!r.ok) return false;
+
+    // The position hash of what was read, as MonopolyDealGame::hash() will
+    // compute it, catches damage that still parses
+    uint64_t expected = ZOBRIST.current[current] ^ ZOBRIST.phase[phase] ^ ZOBRIST.plays[plays] ^ (winner >= 0 ? ZOBRIST.won : 0);
+    for (size_t p = 0; p < count; p++) {
+        for (CardId card : hands[p]) expected ^= ZOBRIST.hand[p][card];
+        expected ^= tables[p].hash() ^ moneyKey(int(p), money[p]) ^ (justSayNo[p] ? ZOBRIST.justSayNo[p] : 0);
+    }
+    for (CardId card : draw) expected ^= ZOBRIST.drawPile[card];
+    for (CardId card : discard) expected ^= ZOBRIST.discardPile[card];
+    if (detail::snapshotCheck(expected, seed, turns, maxTurns, words) != check) return false;
+
+    Xoshiro256 rng;
+    rng.setState(words[0], words[1], words[2], words[3]);
+    for (size_t p = 0; p < count; p++) game.restorePlayer(p, hands[p], tables[p], money[p], justSayNo[p]);
+    game.restoreTurn(draw, discard, rng, seed, current, GamePhase(phase), plays, winner, int(turns), int(maxTurns));
+    return true;
+}
+
+// Checkpoints a whole batch of games in progress: written to a temporary
+// file and renamed over `path`, so a crash mid-write keeps the old one
+template <class Rules>
+bool saveSnapshots(const std::string& path, const std::vector<BasicMonopolyDealGame<Rules>>& games) {
+    std::string temporary = path + ".tmp";
+    FILE* file = fopen(temporary.c_str(), "wb");
+    if (!file) return false;
+    uint8_t buffer[MAX_SNAPSHOT_BYTES + 2];
+    uint8_t header[8];
+    detail::SnapshotWriter w{header};
+    for (char c : snapshot::BATCH_MAGIC) w.u8(uint8_t(c));
+    w.u32(games.size());
+    bool ok = fwrite(header, 1, sizeof(header), file) == sizeof(header);
+    for (size_t g = 0; g < games.size() && ok; g++) {
+        size_t size = writeSnapshot(games[g], buffer + 2);
+        buffer[0] = uint8_t(size);
+        buffer[1] = uint8_t(size >> 8);
+        ok = fwrite(buffer, 1, size + 2, file) == size + 2;
+    }
+    ok = fclose(file) == 0 && ok;
+    return ok && std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+// Restores a batch saved by saveSnapshots into `games`, which must already
+// hold as many games as the file, each with the right number of players
+template <class Rules>
+bool loadSnapshots(const std::string& path, std::vector<BasicMonopolyDealGame<Rules>>& games) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+    uint8_t buffer[MAX_SNAPSHOT_BYTES];
+    uint8_t header[8];
+    bool ok = fread(header, 1, sizeof(header), file) == sizeof(header);
+    detail::SnapshotReader r{header, header + sizeof(header)};
+    for (char c : snapshot::BATCH_MAGIC) ok = ok && r.u8() == uint8_t(c);
+    ok = ok && r.u32() == games.size();
+    for (size_t g = 0; g < games.size() && ok; g++) {
+        uint8_t length[2];
+        ok = fread(length, 1, 2, file) == 2;
+        size_t size = length[0] | size_t(length[1]) << 8;
+        ok = ok && size <= sizeof(buffer) && fread(buffer, 1, size, file) == size && readSnapshot(games[g], buffer, size);
+    }
+    fclose(file);
+    return ok;
+}
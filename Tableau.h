@@ -0,0 +1,175 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "Cards.h"
+#include "Rules.h"
+#include "Zobrist.h"
+
+// A wild card on the table, locked to the color it was played as
+struct WildCard {
+    CardId id;
+    PropertyColor color;
+
+    bool operator==(const WildCard& other) const { return id == other.id && color == other.color; }
+};
+
+// The properties a player has on the table, laid out as fixed per-color
+// slots. Complete sets and rent are kept up to date on every change, so the
+// win check and rent are plain reads. So is this table's share of the
+// position hash. Set sizes come from the rules.
+template <class Rules>
+class BasicPropertyTableau {
+private:
+    std::array<std::array<CardId, MAX_COLOR_CARDS>, NUM_COLORS> cards;
+    std::array<uint8_t, NUM_COLORS> realCount;
+    std::array<uint8_t, NUM_COLORS> wildCount;
+    std::array<WildCard, NUM_WILDS> wilds;
+    uint8_t numWilds;
+    uint8_t seat;
+    // Colors that have an entry on the table, even if it is empty now
+    uint16_t listed;
+    // Colors with at least one real card, i.e. something Sly Deal can take
+    uint16_t occupied;
+    uint16_t complete;
+    uint8_t completeCount;
+    int rentTotal;
+    uint64_t hashValue;
+
+    static uint16_t bit(PropertyColor color) { return uint16_t(1u << int(color)); }
+
+    // Only complete sets with an entry on the table are charged rent
+    static int rentFor(int c, uint16_t listed, uint16_t complete) {
+        return (listed & complete & (1u << c)) ? Rules::SET_SIZES[c] * 2 : 0;
+    }
+
+    void update(PropertyColor color) {
+        int c = int(color);
+        int oldRent = rentFor(c, listed, complete);
+        bool wasComplete = complete & bit(color);
+        bool isNowComplete = realCount[c] + wildCount[c] >= Rules::SET_SIZES[c];
+        if (isNowComplete != wasComplete) {
+            complete ^= bit(color);
+            completeCount += isNowComplete ? 1 : -1;
+        }
+        rentTotal += rentFor(c, listed, complete) - oldRent;
+        if (realCount[c]) occupied |= bit(color);
+        else occupied &= ~bit(color);
+    }
+
+    void setListed(PropertyColor color, bool on) {
+        if (bool(listed & bit(color)) == on) return;
+        int c = int(color);
+        int oldRent = rentFor(c, listed, complete);
+        listed ^= bit(color);
+        rentTotal += rentFor(c, listed, complete) - oldRent;
+        hashValue ^= ZOBRIST.listed[seat][c];
+    }
+
+public:
+    explicit BasicPropertyTableau(int seat = 0)
+        : realCount{}, wildCount{}, numWilds(0), seat(uint8_t(seat)), listed(0), occupied(0), complete(0),
+          completeCount(0), rentTotal(0), hashValue(0) {}
+
+    bool isComplete(PropertyColor color) const { return color != PropertyColor::NONE && (complete & bit(color)); }
+    bool isListed(PropertyColor color) const { return listed & bit(color); }
+    int completeSets() const { return completeCount; }
+    uint16_t listedMask() const { return listed; }
+    uint16_t completeMask() const { return complete; }
+    uint16_t occupiedMask() const { return occupied; }
+    int rent() const { return rentTotal; }
+    uint64_t hash() const { return hashValue; }
+
+    // Real (non-wild) property cards of a color, in the order they were placed
+    size_t count(PropertyColor color) const { return realCount[int(color)]; }
+    CardId card(PropertyColor color, size_t i) const { return cards[int(color)][i]; }
+
+    // Cards counting toward a color's set, wilds included
+    size_t total(PropertyColor color) const { return realCount[int(color)] + wildCount[int(color)]; }
+
+    size_t wildTotal() const { return numWilds; }
+    const WildCard& wild(size_t i) const { return wilds[i]; }
+
+    void add(CardId id, PropertyColor color) {
+        int c = int(color);
+        cards[c][realCount[c]++] = id;
+        hashValue ^= ZOBRIST.table[seat][id];
+        setListed(color, true);
+        update(color);
+    }
+
+    CardId removeTop(PropertyColor color) {
+        int c = int(color);
+        CardId id = cards[c][--realCount[c]];
+        hashValue ^= ZOBRIST.table[seat][id];
+        update(color);
+        return id;
+    }
+
+    void addWild(CardId id, PropertyColor color) {
+        wilds[numWilds++] = {id, color};
+        wildCount[int(color)]++;
+        hashValue ^= ZOBRIST.wild[seat][wildOrdinal(id)][int(color)];
+        update(color);
+    }
+
+    // Undoes the most recent addWild
+    WildCard removeLastWild() {
+        WildCard wild = wilds[--numWilds];
+        wildCount[int(wild.color)]--;
+        hashValue ^= ZOBRIST.wild[seat][wildOrdinal(wild.id)][int(wild.color)];
+        update(wild.color);
+        return wild;
+    }
+
+    // Deal Breaker: our cards of this color are replaced by theirs, and the
+    // color's entry is taken off their table. Their wilds stay where they are.
+    void takeSet(BasicPropertyTableau& from, PropertyColor color) {
+        int c = int(color);
+        replaceColor(color, from.cards[c].data(), from.realCount[c]);
+        setListed(color, true);
+        update(color);
+
+        from.replaceColor(color, nullptr, 0);
+        from.setListed(color, false);
+        from.update(color);
+    }
+
+    // Puts back the exact real cards a color held, for undoing a Deal Breaker
+    void replaceColor(PropertyColor color, const CardId* ids, size_t count) {
+        int c = int(color);
+        for (size_t i = 0; i < realCount[c]; i++) hashValue ^= ZOBRIST.table[seat][cards[c][i]];
+        for (size_t i = 0; i < count; i++) {
+            cards[c][i] = ids[i];
+            hashValue ^= ZOBRIST.table[seat][ids[i]];
+        }
+        realCount[c] = uint8_t(count);
+        update(color);
+    }
+
+    // Puts back which colors had an entry, for undoing a move
+    void restoreListed(uint16_t mask) {
+        for (uint16_t changed = listed ^ mask; changed; changed &= changed - 1) {
+            PropertyColor color = PropertyColor(__builtin_ctz(changed));
+            setListed(color, mask & bit(color));
+            update(color);
+        }
+    }
+
+    bool operator==(const BasicPropertyTableau& other) const {
+        if (realCount != other.realCount || numWilds != other.numWilds || listed != other.listed ||
+            seat != other.seat || hashValue != other.hashValue) return false;
+        for (int c = 0; c < NUM_COLORS; c++) {
+            for (size_t i = 0; i < realCount[c]; i++) {
+                if (cards[c][i] != other.cards[c][i]) return false;
+            }
+        }
+        for (size_t i = 0; i < numWilds; i++) {
+            if (!(wilds[i] == other.wilds[i])) return false;
+        }
+        return true;
+    }
+    bool operator!=(const BasicPropertyTableau& other) const { return !(*this == other); }
+};
+
+using PropertyTableau = BasicPropertyTableau<StandardRules>;
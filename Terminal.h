@@ -0,0 +1,379 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include "MonopolyDeal.h"
+
+// Color codes
+constexpr const char* RED = "\033[31m";
+constexpr const char* GREEN = "\033[32m";
+constexpr const char* YELLOW = "\033[33m";
+constexpr const char* BLUE = "\033[34m";
+constexpr const char* PINK = "\033[35m";
+constexpr const char* CYAN = "\033[36m";
+constexpr const char* WHITE = "\033[37m";
+constexpr const char* RESET = "\033[0m";
+constexpr const char* BOLD = "\033[1m";
+
+inline const char* getColorCode(PropertyColor color) {
+    switch(color) {
+        case PropertyColor::BROWN: return "\033[48;5;94m";
+        case PropertyColor::BLUE: return "\033[48;5;117m";
+        case PropertyColor::PINK: return "\033[48;5;218m";
+        case PropertyColor::ORANGE: return "\033[48;5;214m";
+        case PropertyColor::RED: return "\033[48;5;196m";
+        case PropertyColor::YELLOW: return "\033[48;5;226m";
+        case PropertyColor::GREEN: return "\033[48;5;46m";
+        case PropertyColor::DARKBLUE: return "\033[48;5;21m";
+        case PropertyColor::UTILITY: return "\033[48;5;255m";
+        case PropertyColor::RAILROAD: return "\033[48;5;240m";
+        default: return "\033[48;5;15m";
+    }
+}
+
+inline const char* getCardColor(CardId id) {
+    const CardInfo& card = cardInfo(id);
+    switch(card.type) {
+        case CardType::MONEY: return YELLOW;
+        case CardType::ACTION: return PINK;
+        case CardType::RENT: return RED;
+        case CardType::PROPERTY: return getColorCode(card.color);
+        default: return WHITE;
+    }
+}
+
+inline const std::string& colorName(PropertyColor color) { return PROPERTY_SETS.at(color).second; }
+
+inline void appendInt(std::string& out, long value) {
+    char digits[24];
+    out.append(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr);
+}
+
+// The full status of one player, as a plain scrolling block of text
+inline void appendStatus(std::string& out, const Player& player) {
+    out.append(BOLD).append("\nPlayer: ").append(player.getName()).append(RESET).append("\n");
+    out.append(YELLOW).append("Money: $");
+    appendInt(out, player.getMoney());
+    out.append(RESET).append("\n");
+
+    out.append("Properties:\n");
+    const auto& properties = player.getProperties();
+    for (const auto& [color, req] : PROPERTY_SETS) {
+        if (!properties.isListed(color)) continue;
+        out.append(" - ").append(getColorCode(color)).append(req.second).append(RESET).append(": ");
+        for (size_t i = 0; i < properties.count(color); i++) out.append(cardInfo(properties.card(color, i)).name).append(" ");
+        out.append(player.isCompleteSet(color) ? GREEN : RED).append(player.isCompleteSet(color) ? "(Complete)" : "(Incomplete)");
+        out.append(RESET).append("\n");
+    }
+
+    const auto& hand = player.getHand();
+    out.append("Hand (");
+    appendInt(out, long(hand.size()));
+    out.append(" cards):\n");
+    for (size_t i = 0; i < hand.size(); i++) {
+        appendInt(out, long(i));
+        out.append(": ").append(getCardColor(hand[i])).append(cardInfo(hand[i]).name).append(RESET).append("\n");
+    }
+}
+
+// Characters a string takes on screen, not counting color codes
+inline size_t visibleWidth(const std::string& text) {
+    size_t width = 0;
+    for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] != '\033') width++;
+        else while (i < text.size() && text[i] != 'm') i++;
+    }
+    return width;
+}
+
+// A grid of cells at the top of the screen, redrawn in place. Each frame
+// refills the cells kept from the last one, and diff() emits only the cells
+// whose text changed, skipping cursor moves between neighbours and blanking
+// only what is left of the old text.
+class ScreenRegion {
+private:
+    struct Cell {
+        uint16_t row;
+        uint16_t column;
+        uint16_t shownWidth;
+        std::string text;
+        std::string shown;
+    };
+    std::vector<Cell> cells;
+    size_t used = 0;
+    size_t rows;
+
+public:
+    explicit ScreenRegion(size_t height = 0) : rows(height) {}
+
+    size_t height() const { return rows; }
+
+    // Starts a new frame
+    void begin() { used = 0; }
+
+    // Text of the next cell. Cells are matched with the last frame by
+    // position in the frame, so a frame should lay out the same cells in the
+    // same order every time, even if some of them are empty.
+    std::string& cell(size_t row, size_t column) {
+        if (used == cells.size()) cells.push_back({uint16_t(row), uint16_t(column), 0, "", std::string(1, '\0')});
+        Cell& cell = cells[used++];
+        if (cell.row != row || cell.column != column) {
+            cell.row = uint16_t(row);
+            cell.column = uint16_t(column);
+            cell.shown.assign(1, '\0');
+        }
+        cell.text.clear();
+        return cell.text;
+    }
+
+    // The screen no longer matches, e.g. after it was cleared
+    void invalidate() {
+        for (auto& cell : cells) {
+            cell.shown.assign(1, '\0');
+            cell.shownWidth = 0;
+        }
+    }
+
+    // Appends the escape codes that bring the screen up to date, keeping
+    // the cursor where it was
+    void diff(std::string& out) {
+        for (size_t i = used; i < cells.size(); i++) cells[i].text.clear();
+        bool any = false;
+        size_t cursorRow = 0, cursorColumn = 0;
+        for (auto& cell : cells) {
+            if (cell.text == cell.shown) continue;
+            if (!any) out.append("\0337");
+            if (!any || cursorRow != cell.row || cursorColumn != cell.column) {
+                out.append("\033[");
+                appendInt(out, cell.row + 1);
+                out.append(";");
+                appendInt(out, cell.column + 1);
+                out.append("H");
+            }
+            any = true;
+            out.append(cell.text);
+            if (cell.text.find('\033') != std::string::npos) out.append(RESET);
+            size_t width = visibleWidth(cell.text);
+            if (width < cell.shownWidth) out.append(cell.shownWidth - width, ' ');
+            cursorRow = cell.row;
+            cursorColumn = cell.column + std::max<size_t>(width, cell.shownWidth);
+            cell.shown = cell.text;
+            cell.shownWidth = uint16_t(width);
+        }
+        if (any) out.append("\0338");
+        cells.resize(used);
+    }
+};
+
+// Shows the game as it happens. Each batch of output is built in one
+// reused buffer and written at once, before the next decision. In PANEL
+// mode every player's table and the current hand stay in a panel at the top
+// of the screen, redrawn through a ScreenRegion, while events scroll below
+// it. SCROLL mode prints the full status of the current player before each
+// decision, for terminals without cursor control and for logs.
+class TerminalRenderer : public GameObserver {
+public:
+    enum class Mode { PANEL, SCROLL };
+
+private:
+    // A hand never holds more than 9 cards: 7 plus the 2 drawn
+    static constexpr size_t HAND_ROWS = 4;
+    static constexpr size_t HAND_COLUMNS = 3;
+    static constexpr size_t CARD_WIDTH = 26;
+    static constexpr size_t NAME_WIDTH = 8;
+
+    std::ostream& out;
+    Mode mode;
+    const MonopolyDealGame* game = nullptr;
+    std::string buffer;
+    ScreenRegion panel;
+    uint64_t bytes = 0;
+    int turns = 0;
+
+    void flush() {
+        if (buffer.empty()) return;
+        out.write(buffer.data(), std::streamsize(buffer.size()));
+        out.flush();
+        bytes += buffer.size();
+        buffer.clear();
+    }
+
+    // Every player's table on one row, then the current player's hand
+    void drawPanel() {
+        const auto& players = game->getPlayers();
+        size_t current = game->getCurrentPlayer();
+        panel.begin();
+        panel.cell(0, 0).append(BOLD).append(CYAN).append("=== MONOPOLY DEAL ===");
+        appendInt(panel.cell(0, 22).append("turn "), game->getTurnCount());
+
+        for (size_t p = 0; p < players.size(); p++) {
+            const Player& player = players[p];
+            size_t row = p + 1;
+            panel.cell(row, 0).append(p == current ? "> " : "");
+            panel.cell(row, 2).append(BOLD).append(player.getName(), 0, NAME_WIDTH - 1);
+            appendInt(panel.cell(row, 2 + NAME_WIDTH).append(YELLOW).append("$"), player.getMoney());
+            appendInt(panel.cell(row, 7 + NAME_WIDTH).append("sets "), player.getCompleteSetCount());
+            appendInt(panel.cell(row, 14 + NAME_WIDTH).append("hand "), long(player.getHand().size()));
+            const PropertyTableau& table = player.getProperties();
+            for (int c = 0; c < NUM_COLORS; c++) {
+                PropertyColor color = PropertyColor(c);
+                std::string& text = panel.cell(row, 21 + NAME_WIDTH + 5 * c);
+                if (!table.total(color) && !table.isListed(color)) continue;
+                appendInt(text.append(getColorCode(color)).append(" "), long(table.total(color)));
+                appendInt(text.append("/"), SET_SIZES[c]);
+                text.append(" ");
+            }
+        }
+
+        size_t top = players.size() + 1;
+        panel.cell(top, 0).append("Hand of ").append(players[current].getName()).append(":");
+        const CardPile& hand = players[current].getHand();
+        for (size_t i = 0; i < HAND_ROWS * HAND_COLUMNS; i++) {
+            std::string& text = panel.cell(top + 1 + i / HAND_COLUMNS, (i % HAND_COLUMNS) * CARD_WIDTH);
+            if (i >= hand.size()) continue;
+            appendInt(text, long(i));
+            text.append(": ").append(getCardColor(hand[i])).append(cardInfo(hand[i]).name);
+        }
+        panel.cell(top + 1 + HAND_ROWS, 0).append(HAND_COLUMNS * CARD_WIDTH, '-');
+        panel.diff(buffer);
+    }
+
+public:
+    explicit TerminalRenderer(Mode mode = Mode::PANEL, std::ostream& out = std::cout) : out(out), mode(mode) {}
+
+    ~TerminalRenderer() override {
+        // Give the whole screen back to scrolling
+        if (game && mode == Mode::PANEL) buffer.append("\033[r\n");
+        flush();
+    }
+
+    // Everything written to the terminal so far, and the turns it covered
+    uint64_t bytesWritten() const { return bytes; }
+    int turnsSeen() const { return turns; }
+
+    void onGameStart(const MonopolyDealGame& started) override {
+        game = &started;
+        if (mode == Mode::PANEL) {
+            panel = ScreenRegion(started.getPlayers().size() + HAND_ROWS + 3);
+            panel.invalidate();
+            // Clear the screen, then let only the rows below the panel scroll
+            buffer.append("\033[2J\033[");
+            appendInt(buffer, long(panel.height() + 1));
+            buffer.append("r\033[");
+            appendInt(buffer, long(panel.height() + 1));
+            buffer.append(";1H");
+        }
+        buffer.append(BOLD).append(CYAN).append("=== MONOPOLY DEAL ===\n").append(RESET);
+        buffer.append("First to 3 complete property sets wins!\n");
+    }
+    void onTurnStart(const Player& player) override {
+        turns++;
+        buffer.append(BOLD).append("\n=== ").append(player.getName()).append("'s turn ===\n").append(RESET);
+    }
+    void onReshuffle() override {
+        buffer.append(CYAN).append("Reshuffling discard pile into draw pile!\n").append(RESET);
+    }
+    void onDraw(const Player&, CardId card) override {
+        buffer.append(GREEN).append("Drew: ").append(cardInfo(card).name).append("\n").append(RESET);
+    }
+    void onDrawPileEmpty() override {
+        buffer.append(RED).append("No cards left to draw!\n").append(RESET);
+    }
+    void onDecision(const Player& player) override {
+        if (mode == Mode::PANEL && game) drawPanel();
+        else appendStatus(buffer, player);
+        flush();
+    }
+    void onInvalidPlay(const Player&) override {
+        buffer.append(RED).append("Invalid play! Try again.\n").append(RESET);
+    }
+    void onRentBlocked(const Player& opponent) override {
+        buffer.append(PINK).append(opponent.getName()).append(" plays Just Say No! Rent blocked!\n").append(RESET);
+    }
+    void onRentCollected(const Player& opponent, int amount) override {
+        buffer.append(YELLOW).append("Collected $");
+        appendInt(buffer, amount);
+        buffer.append(" rent from ").append(opponent.getName()).append("\n").append(RESET);
+    }
+    void onNoSetsToSteal() override {
+        buffer.append(RED).append("No complete sets to steal!\n").append(RESET);
+    }
+    void onSetStolen(PropertyColor color) override {
+        buffer.append(GREEN).append("Stole ").append(colorName(color)).append(" set!\n").append(RESET);
+    }
+    void onNoPropertiesToSteal() override {
+        buffer.append(RED).append("No properties to steal!\n").append(RESET);
+    }
+    void onPropertyStolen(PropertyColor color) override {
+        buffer.append(GREEN).append("Stole a ").append(colorName(color)).append(" property!\n").append(RESET);
+    }
+    void onNotEnoughToTrade() override {
+        buffer.append(RED).append("Not enough properties to trade!\n").append(RESET);
+    }
+    void onTraded() override {
+        buffer.append(GREEN).append("Traded properties!\n").append(RESET);
+    }
+    void onWin(const Player& player) override {
+        if (mode == Mode::PANEL && game) drawPanel();
+        buffer.append(BOLD).append(GREEN).append("\n").append(player.getName()).append(" wins with 3 complete property sets!\n").append(RESET);
+        flush();
+    }
+};
+
+// A human at the keyboard
+class TerminalPolicy : public DecisionPolicy {
+private:
+    static int readChoice() {
+        int choice;
+        while (!(std::cin >> choice)) {
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            std::cout << "Invalid input. Try again: ";
+        }
+        return choice;
+    }
+
+    static int chooseColor(const char* prompt, const ColorList& colors) {
+        std::cout << prompt;
+        for (size_t i = 0; i < colors.size(); i++) {
+            std::cout << i << ": " << getColorCode(colors[i]) << colorName(colors[i]) << RESET << "\n";
+        }
+        return readChoice();
+    }
+
+public:
+    int choosePlay(const MonopolyDealGame&, const Player& self) override {
+        std::cout << YELLOW << "Play card (0-" << self.getHand().size()-1 << ") or -1 to end: " << RESET;
+        return readChoice();
+    }
+
+    int chooseWildColor(const Player&, CardId, const ColorList& colors) override {
+        return chooseColor("Choose color for wild card:\n", colors);
+    }
+
+    int chooseSetToSteal(const Player&, const ColorList& sets) override {
+        return chooseColor("Choose set to steal:\n", sets);
+    }
+
+    int choosePropertyToSteal(const Player&, const ColorList& props) override {
+        return chooseColor("Choose property to steal:\n", props);
+    }
+
+    int choosePropertyToGive(const Player&, const ColorList& props) override {
+        return chooseColor("Choose your property to give:\n", props);
+    }
+
+    int choosePropertyToTake(const Player&, const ColorList& props) override {
+        return chooseColor("Choose their property to take:\n", props);
+    }
+
+    int chooseDiscard(const MonopolyDealGame&, const Player& self) override {
+        std::cout << RED << "Discard down to 7. Choose card (0-" << self.getHand().size()-1 << "): " << RESET;
+        return readChoice();
+    }
+};
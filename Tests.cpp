@@ -0,0 +1,127 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+// Counts every heap allocation, so the tests can insist on none
+#define MONOPOLY_COUNT_ALLOCATIONS
+#include "Allocations.h"
+#include "MonopolyDeal.h"
+#include "Policies.h"
+#include "Tournament.h"
+
+using namespace std;
+
+// Regression tests run by ctest. Each one prints what failed and returns 1.
+
+// Every form of operator new must reach the counter
+static int testAllocationCounter() {
+    struct alignas(64) Wide {
+        char bytes[64];
+    };
+    int failures = 0;
+    auto expectOne = [&](const char* form, auto allocate) {
+        allocations::Scope scope;
+        allocate();
+        if (scope.count() != 1) {
+            cerr << form << " counted " << scope.count() << " allocations, not 1\n";
+            failures++;
+        }
+    };
+    // Through a volatile pointer, so the compiler cannot drop the pair
+    static void* volatile kept;
+    expectOne("new", [] { kept = new int(1); delete static_cast<int*>(kept); });
+    expectOne("new[]", [] { kept = new int[4]; delete[] static_cast<int*>(kept); });
+    expectOne("aligned new", [] { kept = new Wide(); delete static_cast<Wide*>(kept); });
+    expectOne("aligned new[]", [] { kept = new Wide[2]; delete[] static_cast<Wide*>(kept); });
+    expectOne("nothrow new", [] { kept = new (nothrow) int(1); delete static_cast<int*>(kept); });
+    expectOne("nothrow new[]", [] { kept = new (nothrow) int[4]; delete[] static_cast<int*>(kept); });
+    return failures ? 1 : 0;
+}
+
+// Once a game is set up, playing it must never touch the heap, whatever the
+// bots and however long the player names (short ones would hide copies in
+// the small-string buffer)
+static int testSteadyStateTurns() {
+    const vector<string> names = {"P1", "a player whose name is far too long for any small-string buffer"};
+    const vector<string> table = {"P1", "P2", "a third player with a long name", "P4"};
+    RandomPolicy first(1), second(2);
+    GreedyPolicy greedy;
+    WeightedPolicy weighted;
+    DecisionPolicy* bots[][2] = {{&first, &second}, {&greedy, &weighted}, {&weighted, &first}, {&greedy, &second}};
+    const int games = 2000;
+
+    uint64_t allocated = 0;
+    long turns = 0;
+    for (int g = 0; g < games; g++) {
+        bool big = g % 5 == 4;
+        MonopolyDealGame game(big ? table : names, deriveSeed(12, g));
+        first.reseed(deriveSeed(13, g));
+        second.reseed(deriveSeed(14, g));
+        for (size_t seat = 0; seat < game.getPlayers().size(); seat++) {
+            game.setPolicy(seat, big ? static_cast<DecisionPolicy*>(seat % 2 ? &first : &second) : bots[g % 4][seat]);
+        }
+        allocations::Scope scope;
+        game.playGame(1000);
+        allocated += scope.count();
+        turns += game.getTurnCount();
+    }
+    if (allocated) {
+        cerr << allocated << " heap allocations during " << turns << " turns of play\n";
+        return 1;
+    }
+    cout << turns << " turns over " << games << " games without an allocation\n";
+    return 0;
+}
+
+// A checkpoint whose write fails (here, a full disk) must leave the last
+// good one in place
+static int testCheckpointWriteFailure() {
+    namespace fs = std::filesystem;
+    if (!fs::exists("/dev/full")) {
+        cout << "no /dev/full here, checkpoint test skipped\n";
+        return 0;
+    }
+    fs::path dir = fs::temp_directory_path() / "monopoly_tests_checkpoint";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    string path = (dir / "totals").string();
+
+    TournamentConfig config;
+    TournamentResult saved(config.players), later(config.players), loaded;
+    saved.games = 5;
+    saved.digest = 42;
+    later.games = 10;
+    int failures = 0;
+    if (!saveTournament(path, config, saved)) {
+        cerr << "could not write a checkpoint\n";
+        failures++;
+    }
+    // The temporary file's writes all land on a full device
+    fs::create_symlink("/dev/full", path + ".tmp");
+    if (saveTournament(path, config, later)) {
+        cerr << "a checkpoint written to a full disk was reported saved\n";
+        failures++;
+    }
+    if (!resumeTournament(path, config, loaded) || loaded.games != 5 || loaded.digest != 42) {
+        cerr << "a failed checkpoint write replaced the last good one\n";
+        failures++;
+    }
+    fs::remove_all(dir);
+    return failures ? 1 : 0;
+}
+
+// monopoly_tests [test...]
+// Tests: allocator, turns, checkpoint (all by default)
+int main(int argc, char* argv[]) {
+    vector<string> tests(argv + 1, argv + argc);
+    auto wanted = [&](const string& name) {
+        return tests.empty() || find(tests.begin(), tests.end(), name) != tests.end();
+    };
+
+    int failures = 0;
+    if (wanted("allocator")) failures += testAllocationCounter();
+    if (wanted("turns")) failures += testSteadyStateTurns();
+    if (wanted("checkpoint")) failures += testCheckpointWriteFailure();
+    return failures ? 1 : 0;
+}
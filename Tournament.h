@@ -0,0 +1,175 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "GameLog.h"
+#include "MonopolyDeal.h"
+#include "Policies.h"
+#include "Rng.h"
+
+struct TournamentConfig {
+    uint64_t games = 10000;
+    int players = 2;
+    int maxTurns = 1000;
+    uint64_t masterSeed = 1;
+    // Plays games firstGame to firstGame + games - 1, so a tournament can
+    // run in pieces whose results merge into the same totals
+    uint64_t firstGame = 0;
+    unsigned threads = 0;   // 0 = one per core
+    // Every game is recorded here when set
+    GameLogWriter* log = nullptr;
+};
+
+// Totals for a batch of games. Everything is a sum, so per-thread results
+// can be merged in any order and still come out bit-identical.
+struct TournamentResult {
+    std::vector<uint64_t> wins;
+    uint64_t unfinished = 0;
+    uint64_t turns = 0;
+    uint64_t games = 0;
+    // Order-independent fingerprint of every game's outcome
+    uint64_t digest = 0;
+
+    explicit TournamentResult(int players = 0) : wins(players, 0) {}
+
+    void add(uint64_t gameIndex, int winner, int turnCount) {
+        if (winner >= 0) wins[winner]++;
+        else unfinished++;
+        turns += turnCount;
+        games++;
+        digest += SplitMix64::mix(gameIndex * 0x100000000ULL + uint64_t(turnCount) * 8 + uint64_t(winner + 1));
+    }
+
+    void merge(const TournamentResult& other) {
+        for (size_t i = 0; i < wins.size(); i++) wins[i] += other.wins[i];
+        unfinished += other.unfinished;
+        turns += other.turns;
+        games += other.games;
+        digest += other.digest;
+    }
+};
+
+// Plays one game of a tournament. Depends only on the master seed and the
+// game's index, never on which thread runs it.
+inline void playTournamentGame(const TournamentConfig& config, const std::vector<std::string>& names,
+                               std::vector<RandomPolicy>& policies, GameLogRecorder* recorder, uint64_t gameIndex,
+                               TournamentResult& result) {
+    uint64_t seed = deriveSeed(config.masterSeed, gameIndex);
+    MonopolyDealGame game(names, seed);
+    for (int i = 0; i < config.players; i++) {
+        policies[i].reseed(deriveSeed(seed, i + 1));
+        game.setPolicy(i, &policies[i]);
+    }
+    game.setObserver(recorder);
+    int winner = game.playGame(config.maxTurns);
+    if (recorder) recorder->finish(game);
+    result.add(gameIndex, winner, game.getTurnCount());
+}
+
+// Spreads independent games over worker threads. Each worker starts with an
+// equal slice of game indices and claims them one at a time; a worker that
+// runs dry steals from the other slices through the same atomic cursor.
+// Results stay thread-local until every worker has joined.
+inline TournamentResult runTournament(const TournamentConfig& config) {
+    unsigned threads = config.threads ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = unsigned(std::min<uint64_t>(threads, std::max<uint64_t>(config.games, 1)));
+
+    struct alignas(64) Slice {
+        std::atomic<uint64_t> next{0};
+        uint64_t end = 0;
+    };
+    std::vector<Slice> slices(threads);
+    for (unsigned t = 0; t < threads; t++) {
+        slices[t].next = config.firstGame + config.games * t / threads;
+        slices[t].end = config.firstGame + config.games * (t + 1) / threads;
+    }
+
+    std::vector<std::string> names;
+    for (int i = 0; i < config.players; i++) names.push_back("P" + std::to_string(i + 1));
+
+    std::vector<TournamentResult> partial(threads, TournamentResult(config.players));
+    auto worker = [&](unsigned self) {
+        std::vector<RandomPolicy> policies(config.players, RandomPolicy(0));
+        std::optional<GameLogRecorder> recorder;
+        if (config.log) recorder.emplace(*config.log);
+        TournamentResult local(config.players);
+        for (unsigned k = 0; k < threads; k++) {
+            Slice& slice = slices[(self + k) % threads];
+            while (true) {
+                uint64_t index = slice.next.fetch_add(1, std::memory_order_relaxed);
+                if (index >= slice.end) break;
+                playTournamentGame(config, names, policies, recorder ? &*recorder : nullptr, index, local);
+            }
+        }
+        partial[self] = local;
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; t++) pool.emplace_back(worker, t);
+    worker(0);
+    for (auto& thread : pool) thread.join();
+
+    TournamentResult total(config.players);
+    for (const auto& result : partial) total.merge(result);
+    return total;
+}
+
+// Totals of the games played so far, as a small text file written to a
+// temporary name and renamed over the old one. A write that fails (a full
+// disk, say) leaves the old file in place.
+inline bool saveTournament(const std::string& path, const TournamentConfig& config, const TournamentResult& result) {
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary);
+        if (!out) return false;
+        out << "monopoly-tournament 1\n";
+        out << "seed " << config.masterSeed << "\n";
+        out << "players " << config.players << "\n";
+        out << "max_turns " << config.maxTurns << "\n";
+        out << "games " << result.games << "\n";
+        out << "wins";
+        for (uint64_t wins : result.wins) out << " " << wins;
+        out << "\n";
+        out << "unfinished " << result.unfinished << "\n";
+        out << "turns " << result.turns << "\n";
+        out << "digest " << result.digest << "\n";
+        // Buffered bytes only fail to reach the disk on flush or close
+        out.flush();
+        out.close();
+        if (out.fail()) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+// Reads totals written by saveTournament; the games they cover are 0 to
+// result.games - 1. False if the file cannot be read or belongs to a
+// tournament with another seed, table size or turn limit.
+inline bool resumeTournament(const std::string& path, const TournamentConfig& config, TournamentResult& result) {
+    std::ifstream in(path);
+    std::string key;
+    int version = 0, players = 0, maxTurns = 0;
+    uint64_t seed = 0;
+    TournamentResult loaded(config.players);
+    if (!(in >> key >> version) || key != "monopoly-tournament" || version != 1) return false;
+    if (!(in >> key >> seed) || key != "seed" || seed != config.masterSeed) return false;
+    if (!(in >> key >> players) || key != "players" || players != config.players) return false;
+    if (!(in >> key >> maxTurns) || key != "max_turns" || maxTurns != config.maxTurns) return false;
+    if (!(in >> key >> loaded.games) || key != "games") return false;
+    if (!(in >> key) || key != "wins") return false;
+    for (uint64_t& wins : loaded.wins) in >> wins;
+    if (!(in >> key >> loaded.unfinished) || key != "unfinished") return false;
+    if (!(in >> key >> loaded.turns) || key != "turns") return false;
+    if (!(in >> key >> loaded.digest) || key != "digest") return false;
+    result = loaded;
+    return true;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Moves.h"
+
+enum class TTBound : uint8_t { NONE, EXACT, LOWER, UPPER };
+
+// What a search learned about one position
+struct TTEntry {
+    uint64_t key;
+    float value;
+    Move best;
+    uint8_t depth;
+    TTBound bound;
+    uint8_t generation;
+};
+
+// Hash table of searched positions keyed by MonopolyDealGame::hash(), sized
+// at runtime. Each key may live in one of two neighbouring slots; when both
+// are taken, entries from older searches and then shallower ones go first.
+class TranspositionTable {
+private:
+    std::vector<TTEntry> entries;
+    size_t mask;
+    uint8_t generation;
+    uint64_t probes;
+    uint64_t hits;
+
+public:
+    explicit TranspositionTable(size_t megabytes = 16) : mask(0), generation(0), probes(0), hits(0) {
+        resize(megabytes);
+    }
+
+    // Rounds down to a power-of-two number of entries (at least two)
+    void resize(size_t megabytes) {
+        size_t count = 2;
+        while (count * 2 * sizeof(TTEntry) <= megabytes * 1024 * 1024) count *= 2;
+        entries.assign(count, TTEntry{});
+        mask = count - 1;
+    }
+
+    void clear() {
+        std::fill(entries.begin(), entries.end(), TTEntry{});
+        probes = hits = 0;
+    }
+
+    // Call at the start of each search so old entries are replaced first
+    void newSearch() { generation++; }
+
+    size_t capacity() const { return entries.size(); }
+    uint64_t probeCount() const { return probes; }
+    uint64_t hitCount() const { return hits; }
+    double hitRate() const { return probes ? double(hits) / probes : 0.0; }
+
+    const TTEntry* probe(uint64_t key) {
+        probes++;
+        size_t slot = key & mask;
+        for (size_t i : {slot, slot ^ 1}) {
+            if (entries[i].bound != TTBound::NONE && entries[i].key == key) {
+                hits++;
+                return &entries[i];
+            }
+        }
+        return nullptr;
+    }
+
+    void store(uint64_t key, float value, int depth, TTBound bound, Move best) {
+        size_t slot = key & mask;
+        TTEntry* target = &entries[slot];
+        TTEntry& other = entries[slot ^ 1];
+        if (target->key != key && (other.key == key || replaceFirst(other, *target))) target = &other;
+        *target = {key, value, best, uint8_t(depth), bound, generation};
+    }
+
+private:
+    // True if `a` is the better slot to overwrite than `b`
+    bool replaceFirst(const TTEntry& a, const TTEntry& b) const {
+        if (a.bound == TTBound::NONE || b.bound == TTBound::NONE) return a.bound == TTBound::NONE;
+        bool aStale = a.generation != generation, bStale = b.generation != generation;
+        if (aStale != bStale) return aStale;
+        return a.depth < b.depth;
+    }
+};
@@ -0,0 +1,267 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MonopolyDeal.h"
+#include "Policies.h"
+#include "Rng.h"
+
+// Self-play tuning of WeightedPolicy's weights with separable CMA-ES: each
+// generation samples candidate weights around a mean, scores them by games
+// against GreedyPolicy and moves the mean (and the per-weight spread and
+// the step size) toward the better half.
+//
+// Every candidate of a generation plays the same deals, once from each
+// seat (common random numbers), so differences in win rate come from the
+// weights and not from the cards. A generation depends only on the master
+// seed, its number and the state before it, so a run resumed from a
+// checkpoint carries on exactly as if it had never stopped.
+struct TunerConfig {
+    int population = 16;     // candidates per generation
+    int deals = 200;         // deals per candidate, each played from both seats
+    int maxTurns = 1000;
+    uint64_t masterSeed = 1;
+    unsigned threads = 0;    // 0 = one per core
+};
+
+// Where the search stands after `generation` generations
+struct TunerState {
+    int generation = 0;
+    double sigma = 1;
+    HeuristicWeights mean = DEFAULT_WEIGHTS;
+    // Diagonal of the covariance, and the two evolution paths
+    HeuristicWeights variance{};
+    HeuristicWeights pathC{};
+    HeuristicWeights pathSigma{};
+    uint64_t games = 0;
+};
+
+struct GenerationResult {
+    double bestFitness;
+    double meanFitness;     // of the mean before this generation's update
+    HeuristicWeights best;
+};
+
+namespace detail {
+
+// Standard normal by Box-Muller, so samples match on every standard library
+inline double gaussian(Xoshiro256& rng) {
+    double u1 = double((rng() >> 11) + 1) * 0x1.0p-53;
+    double u2 = double(rng() >> 11) * 0x1.0p-53;
+    return std::sqrt(-2 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+}
+
+} // namespace detail
+
+// Win rate of each candidate against GreedyPolicy, unfinished games counting
+// half, over deals seeded from `batchSeed`. Candidate-deal pairs are handed
+// out to the worker threads through one atomic cursor; each thread keeps
+// its own tallies until they have all joined.
+inline std::vector<double> evaluateWeights(const std::vector<HeuristicWeights>& candidates, const TunerConfig& config,
+                                           uint64_t batchSeed) {
+    uint64_t jobs = uint64_t(candidates.size()) * config.deals;
+    unsigned threads = config.threads ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = unsigned(std::min<uint64_t>(threads, std::max<uint64_t>(jobs, 1)));
+
+    const std::vector<std::string> names = {"P1", "P2"};
+    std::atomic<uint64_t> next{0};
+    // Half-points: 2 for a win, 1 for an unfinished game
+    std::vector<std::vector<uint64_t>> points(threads, std::vector<uint64_t>(candidates.size()));
+    auto worker = [&](unsigned self) {
+        WeightedPolicy tuned;
+        GreedyPolicy baseline;
+        while (true) {
+            uint64_t job = next.fetch_add(1, std::memory_order_relaxed);
+            if (job >= jobs) break;
+            size_t candidate = job / config.deals;
+            uint64_t deal = job % config.deals;
+            tuned.setWeights(candidates[candidate]);
+            for (int seat = 0; seat < 2; seat++) {
+                MonopolyDealGame game(names, deriveSeed(batchSeed, deal));
+                game.setPolicy(seat, &tuned);
+                game.setPolicy(1 - seat, &baseline);
+                int winner = game.playGame(config.maxTurns);
+                points[self][candidate] += winner == seat ? 2 : winner < 0 ? 1 : 0;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; t++) pool.emplace_back(worker, t);
+    worker(0);
+    for (auto& thread : pool) thread.join();
+
+    std::vector<double> fitness(candidates.size());
+    for (size_t c = 0; c < candidates.size(); c++) {
+        uint64_t sum = 0;
+        for (const auto& tally : points) sum += tally[c];
+        fitness[c] = double(sum) / (4.0 * config.deals);
+    }
+    return fitness;
+}
+
+class HeuristicTuner {
+private:
+    static constexpr int N = NUM_FEATURES;
+
+    TunerConfig config;
+    TunerState current;
+    // Recombination weights and the CMA-ES learning rates, all fixed by
+    // the dimension and the population
+    std::vector<double> recombination;
+    double muEff, cSigma, dSigma, cC, c1, cMu, expectedNorm;
+
+public:
+    explicit HeuristicTuner(const TunerConfig& config) : config(config) {
+        int mu = config.population / 2;
+        for (int i = 0; i < mu; i++) recombination.push_back(std::log(mu + 0.5) - std::log(i + 1.0));
+        double sum = std::accumulate(recombination.begin(), recombination.end(), 0.0), squares = 0;
+        for (double& w : recombination) {
+            w /= sum;
+            squares += w * w;
+        }
+        muEff = 1 / squares;
+        cSigma = (muEff + 2) / (N + muEff + 5);
+        dSigma = 1 + 2 * std::max(0.0, std::sqrt((muEff - 1) / (N + 1)) - 1) + cSigma;
+        cC = (4 + muEff / N) / (N + 4 + 2 * muEff / N);
+        // Separable CMA-ES learns the diagonal (N + 2) / 3 times faster
+        c1 = 2 / ((N + 1.3) * (N + 1.3) + muEff) * (N + 2) / 3;
+        cMu = std::min(1 - c1, 2 * (muEff - 2 + 1 / muEff) / ((N + 2) * (N + 2) + muEff) * (N + 2) / 3);
+        expectedNorm = std::sqrt(double(N)) * (1 - 1.0 / (4 * N) + 1.0 / (21.0 * N * N));
+
+        // Start each weight's spread at half its default, plus a little so
+        // that zero weights can move too
+        for (int f = 0; f < N; f++) {
+            double spread = 0.5 * std::fabs(DEFAULT_WEIGHTS[f]) + 0.1;
+            current.variance[f] = spread * spread;
+        }
+    }
+
+    const TunerState& state() const { return current; }
+
+    // Samples, scores and updates one generation
+    GenerationResult step() {
+        uint64_t generationSeed = deriveSeed(config.masterSeed, uint64_t(current.generation));
+        Xoshiro256 sampler(deriveSeed(generationSeed, 1));
+
+        std::vector<HeuristicWeights> z(config.population), candidates(config.population + 1);
+        for (int k = 0; k < config.population; k++) {
+            for (int f = 0; f < N; f++) {
+                z[k][f] = detail::gaussian(sampler);
+                candidates[k][f] = current.mean[f] + current.sigma * std::sqrt(current.variance[f]) * z[k][f];
+            }
+        }
+        // The mean is scored too, to report progress; it takes no part in the update
+        candidates[config.population] = current.mean;
+
+        std::vector<double> fitness = evaluateWeights(candidates, config, deriveSeed(generationSeed, 2));
+        current.games += uint64_t(candidates.size()) * config.deals * 2;
+
+        std::vector<int> order(config.population);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return fitness[a] > fitness[b]; });
+
+        GenerationResult result{fitness[order[0]], fitness[config.population], candidates[order[0]]};
+
+        HeuristicWeights zMean{}, yMean{};
+        for (size_t i = 0; i < recombination.size(); i++) {
+            for (int f = 0; f < N; f++) zMean[f] += recombination[i] * z[order[i]][f];
+        }
+        for (int f = 0; f < N; f++) {
+            yMean[f] = std::sqrt(current.variance[f]) * zMean[f];
+            current.mean[f] += current.sigma * yMean[f];
+        }
+
+        double pathNorm = 0;
+        for (int f = 0; f < N; f++) {
+            current.pathSigma[f] = (1 - cSigma) * current.pathSigma[f] + std::sqrt(cSigma * (2 - cSigma) * muEff) * zMean[f];
+            pathNorm += current.pathSigma[f] * current.pathSigma[f];
+        }
+        pathNorm = std::sqrt(pathNorm);
+        double decay = 1 - std::pow(1 - cSigma, 2.0 * (current.generation + 1));
+        bool stalled = pathNorm / std::sqrt(decay) >= (1.4 + 2.0 / (N + 1)) * expectedNorm;
+
+        for (int f = 0; f < N; f++) {
+            current.pathC[f] = (1 - cC) * current.pathC[f] + (stalled ? 0 : std::sqrt(cC * (2 - cC) * muEff) * yMean[f]);
+            double rankMu = 0;
+            for (size_t i = 0; i < recombination.size(); i++) {
+                double y = std::sqrt(current.variance[f]) * z[order[i]][f];
+                rankMu += recombination[i] * y * y;
+            }
+            current.variance[f] = (1 - c1 - cMu) * current.variance[f] +
+                                  c1 * (current.pathC[f] * current.pathC[f] + (stalled ? cC * (2 - cC) * current.variance[f] : 0)) +
+                                  cMu * rankMu;
+        }
+        current.sigma *= std::exp(cSigma / dSigma * (pathNorm / expectedNorm - 1));
+        current.generation++;
+        return result;
+    }
+
+    // A small text file, written to a temporary name and renamed over the
+    // old one, so a crash mid-write never loses the previous checkpoint
+    bool save(const std::string& path) const {
+        std::string temporary = path + ".tmp";
+        {
+            std::ofstream out(temporary);
+            char line[64];
+            auto put = [&](const char* key, const HeuristicWeights& values) {
+                out << key;
+                for (double v : values) {
+                    snprintf(line, sizeof(line), " %.17g", v);
+                    out << line;
+                }
+                out << "\n";
+            };
+            snprintf(line, sizeof(line), "%.17g", current.sigma);
+            out << "monopoly-tune 1\n";
+            out << "features " << N << "\n";
+            out << "seed " << config.masterSeed << "\n";
+            out << "population " << config.population << "\n";
+            out << "deals " << config.deals << "\n";
+            out << "generation " << current.generation << "\n";
+            out << "games " << current.games << "\n";
+            out << "sigma " << line << "\n";
+            put("mean", current.mean);
+            put("variance", current.variance);
+            put("path_c", current.pathC);
+            put("path_sigma", current.pathSigma);
+            if (!out) return false;
+        }
+        return std::rename(temporary.c_str(), path.c_str()) == 0;
+    }
+
+    // Picks up a checkpoint written by save. False if it cannot be read or
+    // was written with a different seed, population or number of deals.
+    bool resume(const std::string& path) {
+        std::ifstream in(path);
+        std::string key;
+        int version = 0, features = 0, population = 0, deals = 0;
+        uint64_t seed = 0;
+        TunerState loaded;
+        auto get = [&](const char* name, HeuristicWeights& values) {
+            if (!(in >> key) || key != name) return false;
+            for (double& v : values) in >> v;
+            return bool(in);
+        };
+        if (!(in >> key >> version) || key != "monopoly-tune" || version != 1) return false;
+        if (!(in >> key >> features) || key != "features" || features != N) return false;
+        if (!(in >> key >> seed) || key != "seed" || seed != config.masterSeed) return false;
+        if (!(in >> key >> population) || key != "population" || population != config.population) return false;
+        if (!(in >> key >> deals) || key != "deals" || deals != config.deals) return false;
+        if (!(in >> key >> loaded.generation) || key != "generation") return false;
+        if (!(in >> key >> loaded.games) || key != "games") return false;
+        if (!(in >> key >> loaded.sigma) || key != "sigma") return false;
+        if (!get("mean", loaded.mean) || !get("variance", loaded.variance) || !get("path_c", loaded.pathC) ||
+            !get("path_sigma", loaded.pathSigma)) return false;
+        current = loaded;
+        return true;
+    }
+};
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "Cards.h"
+#include "Tableau.h"
+
+// Best use of wild properties. Every wild of the same kind (same pair of
+// allowed colors) is interchangeable, and no color belongs to two kinds, so
+// each kind can be solved on its own: all that matters is how many of its
+// wilds go to its first color. The answer for every kind, count and state of
+// its two colors is tabulated at compile time, so a solve is a handful of
+// table reads.
+namespace detail {
+
+struct WildKindTable {
+    PropertyColor colors[NUM_WILDS][2];
+    int8_t copies[NUM_WILDS];
+    int8_t kindOf[NUM_CARDS];
+    int count;
+};
+
+constexpr WildKindTable buildWildKinds() {
+    WildKindTable table{};
+    for (int id = 0; id < NUM_CARDS; id++) {
+        table.kindOf[id] = -1;
+        const CardInfo& card = CARD_CATALOG[id];
+        if (!card.isWild) continue;
+        int k = 0;
+        while (k < table.count && (table.colors[k][0] != card.wildColors[0] || table.colors[k][1] != card.wildColors[1])) k++;
+        if (k == table.count) {
+            table.colors[k][0] = card.wildColors[0];
+            table.colors[k][1] = card.wildColors[1];
+            table.count++;
+        }
+        table.copies[k]++;
+        table.kindOf[id] = int8_t(k);
+    }
+    return table;
+}
+
+constexpr WildKindTable WILD_KINDS = buildWildKinds();
+
+constexpr bool wildKindsDisjoint() {
+    int owners[NUM_COLORS + 1] = {};
+    for (int k = 0; k < WILD_KINDS.count; k++) {
+        if (WILD_KINDS.colors[k][0] == WILD_KINDS.colors[k][1]) return false;
+        for (PropertyColor color : WILD_KINDS.colors[k]) {
+            if (color == PropertyColor::NONE || owners[int(color)]++) return false;
+        }
+    }
+    return true;
+}
+
+constexpr int maxWildCopies() {
+    int most = 0;
+    for (int k = 0; k < WILD_KINDS.count; k++) most = WILD_KINDS.copies[k] > most ? WILD_KINDS.copies[k] : most;
+    return most;
+}
+
+} // namespace detail
+
+static_assert(detail::wildKindsDisjoint(), "the wild solver needs every color in at most one kind of wild");
+
+constexpr int NUM_WILD_KINDS = detail::WILD_KINDS.count;
+constexpr int MAX_WILD_COPIES = detail::maxWildCopies();
+
+// Kind of a wild card (0 to NUM_WILD_KINDS-1), or -1
+constexpr int wildKind(CardId id) { return detail::WILD_KINDS.kindOf[id]; }
+constexpr PropertyColor wildKindColor(int kind, int side) { return detail::WILD_KINDS.colors[kind][side]; }
+
+// A table to fill with wilds: cards per color that stay where they are,
+// which colors have an entry (only those are charged rent) and how many
+// wilds of each kind there are to place
+struct WildProblem {
+    uint8_t fixed[NUM_COLORS];
+    uint16_t listed;
+    uint8_t wilds[NUM_WILD_KINDS];
+};
+
+// Most complete sets, then most rent; among equals, the split that leaves
+// an unfinished set closest to complete
+struct WildAssignment {
+    uint8_t toFirst[NUM_WILD_KINDS];
+    int completeSets;
+    int rent;
+
+    PropertyColor colorFor(int kind) const {
+        return toFirst[kind] ? wildKindColor(kind, 0) : wildKindColor(kind, 1);
+    }
+};
+
+namespace detail {
+
+// A color's distance from complete only matters up to "more than all the
+// wilds of a kind can cover"
+constexpr int WILD_DEFICITS = MAX_WILD_COPIES + 2;
+
+struct WildChoice {
+    uint8_t toFirst;
+    uint8_t sets;
+    uint8_t rent;
+};
+
+constexpr int wildChoiceIndex(int wilds, int deficitA, int deficitB, bool listedA, bool listedB) {
+    return (((wilds * WILD_DEFICITS + deficitA) * WILD_DEFICITS + deficitB) * 2 + listedA) * 2 + listedB;
+}
+
+constexpr int WILD_CHOICES = (MAX_WILD_COPIES + 1) * WILD_DEFICITS * WILD_DEFICITS * 4;
+
+using WildChoiceTable = std::array<std::array<WildChoice, WILD_CHOICES>, NUM_WILD_KINDS>;
+
+constexpr WildChoiceTable buildWildChoices() {
+    WildChoiceTable table{};
+    for (int k = 0; k < NUM_WILD_KINDS; k++) {
+        int sizeA = SET_SIZES[int(WILD_KINDS.colors[k][0])];
+        int sizeB = SET_SIZES[int(WILD_KINDS.colors[k][1])];
+        for (int n = 0; n <= MAX_WILD_COPIES; n++)
+        for (int da = 0; da < WILD_DEFICITS; da++)
+        for (int db = 0; db < WILD_DEFICITS; db++)
+        for (int la = 0; la < 2; la++)
+        for (int lb = 0; lb < 2; lb++) {
+            WildChoice best{0, 0, 0};
+            int bestClosest = 0;
+            for (int x = n; x >= 0; x--) {
+                bool fullA = x >= da, fullB = n - x >= db;
+                int sets = fullA + fullB;
+                int rent = (fullA && la ? 2 * sizeA : 0) + (fullB && lb ? 2 * sizeB : 0);
+                int missingA = fullA ? WILD_DEFICITS : da - x, missingB = fullB ? WILD_DEFICITS : db - (n - x);
+                int closest = missingA < missingB ? missingA : missingB;
+                if (x == n || sets > best.sets || (sets == best.sets && rent > best.rent) ||
+                    (sets == best.sets && rent == best.rent && closest < bestClosest)) {
+                    best = {uint8_t(x), uint8_t(sets), uint8_t(rent)};
+                    bestClosest = closest;
+                }
+            }
+            table[k][wildChoiceIndex(n, da, db, la, lb)] = best;
+        }
+    }
+    return table;
+}
+
+constexpr WildChoiceTable WILD_CHOICES_BY_KIND = buildWildChoices();
+
+// Colors no wild can reach
+constexpr uint16_t fixedColorMask() {
+    uint16_t mask = (1u << NUM_COLORS) - 1;
+    for (int k = 0; k < NUM_WILD_KINDS; k++) {
+        for (PropertyColor color : WILD_KINDS.colors[k]) mask &= uint16_t(~(1u << int(color)));
+    }
+    return mask;
+}
+
+} // namespace detail
+
+inline WildAssignment solveWilds(const WildProblem& problem) {
+    WildAssignment result{};
+    for (uint16_t fixed = detail::fixedColorMask(); fixed; fixed &= fixed - 1) {
+        int c = __builtin_ctz(fixed);
+        if (problem.fixed[c] < SET_SIZES[c]) continue;
+        result.completeSets++;
+        if (problem.listed & (1u << c)) result.rent += 2 * SET_SIZES[c];
+    }
+    for (int k = 0; k < NUM_WILD_KINDS; k++) {
+        int a = int(wildKindColor(k, 0)), b = int(wildKindColor(k, 1));
+        auto deficit = [&](int c) {
+            int missing = SET_SIZES[c] > problem.fixed[c] ? SET_SIZES[c] - problem.fixed[c] : 0;
+            return missing < detail::WILD_DEFICITS ? missing : detail::WILD_DEFICITS - 1;
+        };
+        int wilds = problem.wilds[k] < MAX_WILD_COPIES ? problem.wilds[k] : MAX_WILD_COPIES;
+        const detail::WildChoice& choice = detail::WILD_CHOICES_BY_KIND[k][detail::wildChoiceIndex(
+            wilds, deficit(a), deficit(b), (problem.listed >> a) & 1, (problem.listed >> b) & 1)];
+        result.toFirst[k] = choice.toFirst;
+        result.completeSets += choice.sets;
+        result.rent += choice.rent;
+    }
+    return result;
+}
+
+// The problem for a player's table and hand. Wilds already on the table
+// are locked to their color unless `reassign` is set, which answers what
+// the table would be worth if they could move, e.g. after a theft.
+template <class Hand>
+WildProblem wildProblem(const PropertyTableau& table, const Hand& hand, bool reassign = false) {
+    WildProblem problem{};
+    for (int c = 0; c < NUM_COLORS; c++) {
+        PropertyColor color = PropertyColor(c);
+        problem.fixed[c] = uint8_t(reassign ? table.count(color) : table.total(color));
+    }
+    problem.listed = table.listedMask();
+    for (CardId card : hand) {
+        if (wildKind(card) >= 0) problem.wilds[wildKind(card)]++;
+    }
+    if (reassign) {
+        for (size_t i = 0; i < table.wildTotal(); i++) problem.wilds[wildKind(table.wild(i).id)]++;
+    }
+    return problem;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "Cards.h"
+#include "Rng.h"
+
+// Random keys for Zobrist hashing of a game position. A position's hash is
+// the XOR of the keys of everything in it, so each change to the state
+// updates the hash with one or two XORs.
+struct ZobristKeys {
+    std::array<std::array<uint64_t, NUM_CARDS>, MAX_SEATS> hand;
+    std::array<std::array<uint64_t, NUM_CARDS>, MAX_SEATS> table;
+    std::array<std::array<std::array<uint64_t, NUM_COLORS>, NUM_WILDS>, MAX_SEATS> wild;
+    std::array<std::array<uint64_t, NUM_COLORS>, MAX_SEATS> listed;
+    std::array<std::array<uint64_t, MAX_MONEY + 1>, MAX_SEATS> money;
+    std::array<uint64_t, MAX_SEATS> justSayNo;
+    std::array<uint64_t, NUM_CARDS> drawPile;
+    std::array<uint64_t, NUM_CARDS> discardPile;
+    std::array<uint64_t, MAX_SEATS> current;
+    std::array<uint64_t, 4> phase;
+    std::array<uint64_t, 8> plays;
+    uint64_t won;
+};
+
+namespace detail {
+
+constexpr ZobristKeys buildZobristKeys() {
+    ZobristKeys keys{};
+    SplitMix64 stream(0x5eed2b0b5eedULL);
+    for (int p = 0; p < MAX_SEATS; p++) {
+        for (auto& key : keys.hand[p]) key = stream.next();
+        for (auto& key : keys.table[p]) key = stream.next();
+        for (auto& colors : keys.wild[p]) {
+            for (auto& key : colors) key = stream.next();
+        }
+        for (auto& key : keys.listed[p]) key = stream.next();
+        for (auto& key : keys.money[p]) key = stream.next();
+        keys.justSayNo[p] = stream.next();
+        keys.current[p] = stream.next();
+    }
+    for (auto& key : keys.drawPile) key = stream.next();
+    for (auto& key : keys.discardPile) key = stream.next();
+    for (auto& key : keys.phase) key = stream.next();
+    for (auto& key : keys.plays) key = stream.next();
+    keys.won = stream.next();
+    return keys;
+}
+
+} // namespace detail
+
+inline constexpr ZobristKeys ZOBRIST = detail::buildZobristKeys();
+
+inline uint64_t moneyKey(int seat, int money) {
+    return ZOBRIST.money[seat][money < 0 ? 0 : money > MAX_MONEY ? MAX_MONEY : money];
+}